@@ -0,0 +1,182 @@
+#include "addressAnchor.h"
+#include "errorHandler.h"
+//=====================//
+#include <windows.h>
+#include <tlhelp32.h>
+#include <algorithm>
+#include <cwctype>
+#include <string>
+#include <vector>
+
+static const size_t kSignatureRadius = 32;        // bytes kept on each side of the value
+static const size_t kReacquireRadius = 64 * 1024; // how far from the expected address to look
+static const float kMinSignatureMatch = 0.75f;    // share of signature bytes that must still match
+
+std::vector<ModuleInfo> listProcessModules(DWORD pid) {
+    std::vector<ModuleInfo> modules;
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
+    if (hSnapshot == INVALID_HANDLE_VALUE) {
+        LOG_WARNING("Failed to snapshot modules of PID " + std::to_string(pid) + ": " + std::to_string(GetLastError()));
+        return modules;
+    }
+    REGISTER_HANDLE(hSnapshot);
+
+    MODULEENTRY32 entry;
+    entry.dwSize = sizeof(MODULEENTRY32);
+    if (Module32First(hSnapshot, &entry)) {
+        do {
+            modules.push_back({ entry.szModule, reinterpret_cast<uintptr_t>(entry.modBaseAddr), static_cast<size_t>(entry.modBaseSize) });
+        } while (Module32Next(hSnapshot, &entry));
+    }
+
+    CloseHandle(hSnapshot);
+    UNREGISTER_HANDLE(hSnapshot);
+    return modules;
+}
+
+static bool sameModuleName(const std::wstring& a, const std::wstring& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](wchar_t x, wchar_t y) {
+        return std::towlower(x) == std::towlower(y);
+    });
+}
+
+bool buildAddressAnchor(DWORD pid, uintptr_t address, const std::vector<ModuleInfo>& modules, AddressAnchor& out) {
+    out = AddressAnchor();
+    out.lastAddress = address;
+    for (const auto& module : modules) {
+        if (address >= module.base && address < module.base + module.size) {
+            out.moduleName = module.name;
+            out.moduleOffset = address - module.base;
+            break;
+        }
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+    if (process_handle == NULL) {
+        return !out.moduleName.empty();
+    }
+    REGISTER_HANDLE(process_handle);
+
+    uintptr_t start = address >= kSignatureRadius ? address - kSignatureRadius : 0;
+    std::vector<uint8_t> bytes(address - start + sizeof(int32_t) + kSignatureRadius);
+    SIZE_T bytes_read = 0;
+    if (ReadProcessMemory(process_handle, (LPCVOID)start, bytes.data(), bytes.size(), &bytes_read) && bytes_read == bytes.size()) {
+        out.signature = bytes;
+        out.valueOffset = address - start;
+    }
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+    return !out.moduleName.empty() || !out.signature.empty();
+}
+
+std::vector<AddressAnchor> buildAddressAnchors(DWORD pid, const std::vector<uintptr_t>& addresses) {
+    std::vector<AddressAnchor> anchors;
+    std::vector<ModuleInfo> modules = listProcessModules(pid);
+    for (uintptr_t address : addresses) {
+        AddressAnchor anchor;
+        if (buildAddressAnchor(pid, address, modules, anchor)) {
+            anchors.push_back(anchor);
+        }
+    }
+    return anchors;
+}
+
+// Share of signature bytes (value bytes excluded) that match at `data`,
+// giving up early once the threshold can no longer be reached
+static float signatureMatch(const AddressAnchor& anchor, const uint8_t* data) {
+    const size_t compared = anchor.signature.size() - sizeof(int32_t);
+    const size_t allowedMisses = static_cast<size_t>(compared * (1.0f - kMinSignatureMatch));
+    size_t misses = 0;
+    for (size_t i = 0; i < anchor.signature.size(); ++i) {
+        if (i >= anchor.valueOffset && i < anchor.valueOffset + sizeof(int32_t)) {
+            continue;
+        }
+        if (data[i] != anchor.signature[i] && ++misses > allowedMisses) {
+            return 0.0f;
+        }
+    }
+    return 1.0f - static_cast<float>(misses) / compared;
+}
+
+bool reacquireAddress(DWORD pid, const AddressAnchor& anchor, const std::vector<ModuleInfo>& modules, uintptr_t& address) {
+    uintptr_t expected = anchor.lastAddress;
+    bool moduleFound = false;
+    if (!anchor.moduleName.empty()) {
+        for (const auto& module : modules) {
+            if (sameModuleName(module.name, anchor.moduleName)) {
+                expected = module.base + anchor.moduleOffset;
+                moduleFound = true;
+                break;
+            }
+        }
+        if (!moduleFound) {
+            return false;
+        }
+    }
+
+    if (anchor.signature.empty()) {
+        address = expected;
+        return moduleFound;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+    if (process_handle == NULL) {
+        return false;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    // Window of signature start positions centred on where the signature should begin
+    uintptr_t expectedStart = expected - anchor.valueOffset;
+    uintptr_t windowStart = expectedStart >= kReacquireRadius ? expectedStart - kReacquireRadius : 0;
+    std::vector<uint8_t> window(expectedStart - windowStart + kReacquireRadius + anchor.signature.size());
+    SIZE_T bytes_read = 0;
+    if (!ReadProcessMemory(process_handle, (LPCVOID)windowStart, window.data(), window.size(), &bytes_read) || bytes_read < anchor.signature.size()) {
+        // Window crosses an unreadable page; settle for the exact expected spot
+        windowStart = expectedStart;
+        window.assign(anchor.signature.size(), 0);
+        if (!ReadProcessMemory(process_handle, (LPCVOID)windowStart, window.data(), window.size(), &bytes_read) || bytes_read != window.size()) {
+            CloseHandle(process_handle);
+            UNREGISTER_HANDLE(process_handle);
+            return false;
+        }
+    }
+    window.resize(bytes_read);
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    float bestScore = 0.0f;
+    uintptr_t bestDistance = ~static_cast<uintptr_t>(0);
+    for (size_t pos = 0; pos + anchor.signature.size() <= window.size(); ++pos) {
+        float match = signatureMatch(anchor, window.data() + pos);
+        if (match == 0.0f) {
+            continue;
+        }
+        uintptr_t candidate = windowStart + pos;
+        uintptr_t distance = candidate > expectedStart ? candidate - expectedStart : expectedStart - candidate;
+        if (match > bestScore || (match == bestScore && distance < bestDistance)) {
+            bestScore = match;
+            bestDistance = distance;
+            address = candidate + anchor.valueOffset;
+        }
+    }
+    return bestScore >= kMinSignatureMatch;
+}
+
+std::vector<uintptr_t> reacquireAddresses(DWORD pid, const std::vector<AddressAnchor>& anchors) {
+    std::vector<uintptr_t> addresses;
+    if (anchors.empty()) {
+        return addresses;
+    }
+    std::vector<ModuleInfo> modules = listProcessModules(pid);
+    for (const auto& anchor : anchors) {
+        uintptr_t address = 0;
+        if (reacquireAddress(pid, anchor, modules, address)) {
+            addresses.push_back(address);
+        }
+    }
+    std::sort(addresses.begin(), addresses.end());
+    addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+    return addresses;
+}
@@ -0,0 +1,36 @@
+#ifndef ADDRESSANCHOR_H
+#define ADDRESSANCHOR_H
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+struct ModuleInfo {
+    std::wstring name;
+    uintptr_t base;
+    size_t size;
+};
+
+// A found address in a form that survives a target restart: module + offset
+// when it lies in an image, plus the bytes around it (value bytes masked out)
+// so it can be found again near where it is expected.
+struct AddressAnchor {
+    std::wstring moduleName;      // empty for heap/stack addresses
+    uintptr_t moduleOffset = 0;
+    uintptr_t lastAddress = 0;    // absolute address in the process it was taken from
+    std::vector<uint8_t> signature;
+    size_t valueOffset = 0;       // position of the value inside signature
+};
+
+std::vector<ModuleInfo> listProcessModules(DWORD pid);
+
+bool buildAddressAnchor(DWORD pid, uintptr_t address, const std::vector<ModuleInfo>& modules, AddressAnchor& out);
+std::vector<AddressAnchor> buildAddressAnchors(DWORD pid, const std::vector<uintptr_t>& addresses);
+
+// Module lookup first, then a bounded signature search around the expected
+// address. Returns false if neither finds a good enough match.
+bool reacquireAddress(DWORD pid, const AddressAnchor& anchor, const std::vector<ModuleInfo>& modules, uintptr_t& address);
+std::vector<uintptr_t> reacquireAddresses(DWORD pid, const std::vector<AddressAnchor>& anchors);
+
+#endif
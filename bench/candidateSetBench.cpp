@@ -0,0 +1,100 @@
+// Candidate set algebra on two scan-sized sets, against a single-threaded
+// std::set_* merge. "dense" hits land every few bytes of one heap range (a
+// scan for 0 or 1), "sparse" ones kilobytes apart (a scan for a rare value).
+//   make bench && build/bench/candidateSetBench [millions per set]
+#include "../candidateSet.h"
+//=====================//
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Walks the address space in random steps up to maxGap; each address lands in
+// a, b, both or neither, so the sets overlap by about two thirds
+static void generateSets(size_t entries, uintptr_t maxGap, std::vector<uintptr_t>& a, std::vector<uintptr_t>& b) {
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<uintptr_t> gap(1, maxGap);
+    std::uniform_int_distribution<int> membership(0, 5);
+    a.clear();
+    b.clear();
+    a.reserve(entries);
+    b.reserve(entries);
+    uintptr_t address = 0x10000000;
+    while (a.size() < entries || b.size() < entries) {
+        address += gap(random);
+        int side = membership(random);
+        if (side <= 3 && a.size() < entries) {
+            a.push_back(address);
+        }
+        if (side >= 2 && b.size() < entries) {
+            b.push_back(address);
+        }
+    }
+}
+
+static double millisecondsSince(BenchClock::time_point started) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - started).count();
+}
+
+using SetFn = std::function<std::vector<uintptr_t>(const std::vector<uintptr_t>&, const std::vector<uintptr_t>&)>;
+using StdFn = std::function<void(const std::vector<uintptr_t>&, const std::vector<uintptr_t>&, std::vector<uintptr_t>&)>;
+
+static bool runOperation(const char* name, const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b, const SetFn& combine,
+                         const StdFn& reference) {
+    auto started = BenchClock::now();
+    std::vector<uintptr_t> result = combine(a, b);
+    double combineMs = millisecondsSince(started);
+
+    std::vector<uintptr_t> expected;
+    expected.reserve(result.size());
+    started = BenchClock::now();
+    reference(a, b, expected);
+    double referenceMs = millisecondsSince(started);
+
+    bool same = result == expected;
+    std::printf("  %-9s %10zu entries  %8.1f ms  (std::set_* %8.1f ms, %.1fx)%s\n", name, result.size(), combineMs, referenceMs,
+                referenceMs / std::max(combineMs, 0.001), same ? "" : "  MISMATCH");
+    return same;
+}
+
+static bool runScenario(const char* name, size_t entries, uintptr_t maxGap) {
+    std::vector<uintptr_t> a, b;
+    generateSets(entries, maxGap, a, b);
+    std::printf("%s: 2 x %zu entries, gaps up to %zu bytes\n", name, entries, static_cast<size_t>(maxGap));
+
+    bool ok = true;
+    ok &= runOperation("intersect", a, b, intersectCandidates, [](const auto& x, const auto& y, auto& out) {
+        std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(out));
+    });
+    ok &= runOperation("unite", a, b, uniteCandidates, [](const auto& x, const auto& y, auto& out) {
+        std::set_union(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(out));
+    });
+    ok &= runOperation("subtract", a, b, subtractCandidates, [](const auto& x, const auto& y, auto& out) {
+        std::set_difference(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(out));
+    });
+
+    // A refined list against a fresh scan: thousands of entries against millions
+    std::vector<uintptr_t> few;
+    for (size_t i = 0; i < a.size(); i += 10000) {
+        few.push_back(a[i]);
+    }
+    ok &= runOperation("lopsided", few, b, intersectCandidates, [](const auto& x, const auto& y, auto& out) {
+        std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(out));
+    });
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    size_t millions = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 50;
+    std::printf("%u hardware thread(s)\n", std::max(1u, std::thread::hardware_concurrency()));
+    bool ok = runScenario("dense", millions * 1000000, 8);
+    ok &= runScenario("sparse", millions * 1000000, 4096);
+    return ok ? 0 : 1;
+}
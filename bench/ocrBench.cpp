@@ -0,0 +1,395 @@
+// OCR accuracy and latency over a labeled corpus of HUD number crops, with
+// the same preprocessing, text narrowing and recognizers as the live path.
+//   make bench
+//   build/bench/ocrBench --generate corpus [count]   writes a synthetic corpus
+//   build/bench/ocrBench [--tessdata dir] [--tesseract-only] corpus > results.tsv
+//   build/bench/ocrBench [--tessdata dir] [--tesseract-only] --replay dir|video > readings.tsv
+//
+// A corpus is a directory with labels.tsv: one "relative/path.png<TAB>text"
+// per line; the path's directory names the sample's category (font,
+// background, ...). Results are tab-separated lines in a fixed order, so two
+// builds' outputs can be diffed directly.
+//
+// --replay feeds a recorded session (the same PNG directory or video the
+// program's own --replay takes) through the live path's per-region state and
+// prints one line per recognized region, then throughput and stage latency.
+// It stops at the OCR text: the memory search behind it is Windows-only.
+#include "../imagePreprocess.h"
+#include "../textBounds.h"
+#include "../frameChange.h"
+#include "../frameSource.h"
+#include "../glyphRecognizer.h"
+#include "../ocrEnginePool.h"
+//=====================//
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace fs = std::filesystem;
+using BenchClock = std::chrono::steady_clock;
+
+static const char* const kStageNames[] = { "preprocess", "bounds", "glyphs", "tesseract", "total" };
+enum BenchStage { Preprocess, Bounds, Glyphs, Tesseract, Total, StageCount };
+
+struct Sample {
+    std::string path;
+    std::string expected;
+    std::string category;
+};
+
+struct Score {
+    size_t samples = 0;
+    size_t exact = 0;
+    size_t edits = 0;
+    size_t characters = 0;
+};
+
+static std::string withoutSpaces(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            out += c;
+        }
+    }
+    return out;
+}
+
+static size_t editDistance(const std::string& a, const std::string& b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t above = row[j];
+            row[j] = std::min({ row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1) });
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+static long long percentile(std::vector<long long> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static long long microsSince(BenchClock::time_point started) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(BenchClock::now() - started).count();
+}
+
+static std::vector<Sample> loadLabels(const fs::path& corpus) {
+    std::vector<Sample> samples;
+    std::ifstream labels(corpus / "labels.tsv");
+    std::string line;
+    while (std::getline(labels, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t tab = line.find('\t');
+        if (line.empty() || line[0] == '#' || tab == std::string::npos) {
+            continue;
+        }
+        Sample sample;
+        sample.path = line.substr(0, tab);
+        sample.expected = withoutSpaces(line.substr(tab + 1));
+        sample.category = fs::path(sample.path).parent_path().generic_string();
+        if (sample.category.empty()) {
+            sample.category = ".";
+        }
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+// Numbers as HUDs print them, in OpenCV's Hershey fonts over a few backgrounds
+static int generateCorpus(const fs::path& corpus, int count) {
+    const std::pair<int, const char*> fonts[] = { { cv::FONT_HERSHEY_SIMPLEX, "simplex" },
+                                                  { cv::FONT_HERSHEY_DUPLEX, "duplex" },
+                                                  { cv::FONT_HERSHEY_COMPLEX, "complex" },
+                                                  { cv::FONT_HERSHEY_TRIPLEX, "triplex" },
+                                                  { cv::FONT_HERSHEY_PLAIN, "plain" } };
+    const char* const backgrounds[] = { "dark", "light", "gradient", "noise" };
+    const double scales[] = { 0.5, 0.8, 1.2, 2.0 };
+
+    cv::RNG rng(48);
+    std::ofstream labels(corpus / "labels.tsv");
+    labels << "# path\ttext\n";
+    for (int i = 0; i < count; ++i) {
+        int value = rng.uniform(0, 100000);
+        std::string text;
+        switch (rng.uniform(0, 5)) {
+            case 0: text = std::to_string(value); break;
+            case 1: text = "-" + std::to_string(value % 1000); break;
+            case 2: text = std::to_string(value / 1000 + 1) + "," + cv::format("%03d", value % 1000); break;
+            case 3: text = cv::format("%d.%dk", value % 1000, value % 10); break;
+            default: text = std::to_string(value % 1000) + "/" + std::to_string(value % 1000 + rng.uniform(1, 500)); break;
+        }
+
+        const auto& font = fonts[rng.uniform(0, 5)];
+        const char* background = backgrounds[rng.uniform(0, 4)];
+        double scale = scales[rng.uniform(0, 4)];
+        int thickness = scale >= 1.2 ? 2 : 1;
+        int baseline = 0;
+        cv::Size size = cv::getTextSize(text, font.first, scale, thickness, &baseline);
+        int pad = std::max(4, size.height / 2);
+        cv::Mat image(size.height + baseline + 2 * pad, size.width + 2 * pad, CV_8UC3);
+
+        bool lightText = std::string(background) != "light";
+        if (std::string(background) == "gradient") {
+            for (int x = 0; x < image.cols; ++x) {
+                image.col(x).setTo(cv::Scalar::all(20 + 80 * x / std::max(1, image.cols - 1)));
+            }
+        } else {
+            image.setTo(cv::Scalar::all(lightText ? 25 : 225));
+            if (std::string(background) == "noise") {
+                cv::Mat noise(image.size(), image.type());
+                rng.fill(noise, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(40));
+                image += noise;
+            }
+        }
+        cv::Scalar ink = lightText ? cv::Scalar(235, 235, 235) : cv::Scalar(20, 20, 20);
+        cv::putText(image, text, cv::Point(pad, pad + size.height), font.first, scale, ink, thickness, cv::LINE_AA);
+
+        fs::path relative = fs::path(std::string(font.second) + "-" + background) / cv::format("%04d.png", i);
+        fs::create_directories(corpus / relative.parent_path());
+        cv::imwrite((corpus / relative).string(), image);
+        labels << relative.generic_string() << '\t' << text << '\n';
+    }
+    std::fprintf(stderr, "Wrote %d samples to %s\n", count, corpus.string().c_str());
+    return 0;
+}
+
+struct ReadCounts {
+    size_t glyphReads = 0;
+    size_t glyphCorrections = 0; // cross-checks where Tesseract disagreed with a confident glyph read
+};
+
+// Glyph recognizer first, Tesseract when it is unsure or a cross-check is due;
+// what Tesseract reads confidently teaches the glyph recognizer, as in the recognize stage
+static std::string readText(const cv::Mat& binary, GlyphRecognizer& glyphs, bool useGlyphs, std::vector<long long>* latencies, ReadCounts& counts) {
+    GlyphReadout fast;
+    bool confident = false;
+    if (useGlyphs) {
+        auto stageStarted = BenchClock::now();
+        fast = glyphs.recognize(binary);
+        latencies[Glyphs].push_back(microsSince(stageStarted));
+        confident = GlyphRecognizer::isConfident(fast);
+        if (confident && !glyphs.dueForCrossCheck()) {
+            ++counts.glyphReads;
+            return fast.text;
+        }
+    }
+    auto stageStarted = BenchClock::now();
+    OcrConfidence confidence;
+    std::string got = ocrEngines.recognize(binary, &confidence);
+    latencies[Tesseract].push_back(microsSince(stageStarted));
+    if (confident && withoutSpaces(got) != withoutSpaces(fast.text)) {
+        ++counts.glyphCorrections;
+    }
+    if (useGlyphs && confidence.mean >= kGlyphLearnConfidence) {
+        glyphs.learn(binary, got);
+    }
+    return got;
+}
+
+static void printLatencies(const std::vector<long long>* latencies) {
+    for (int stage = 0; stage < StageCount; ++stage) {
+        std::printf("latency_us\t%s\tcount\t%zu\n", kStageNames[stage], latencies[stage].size());
+        std::printf("latency_us\t%s\tp50\t%lld\n", kStageNames[stage], percentile(latencies[stage], 0.50));
+        std::printf("latency_us\t%s\tp99\t%lld\n", kStageNames[stage], percentile(latencies[stage], 0.99));
+    }
+}
+
+// Every region keeps its preprocessor, text box and change detector across
+// frames, so unchanged frames are skipped and the text box is tracked exactly
+// as the pipeline does. "total" is per frame here, not per region.
+static int replayRecording(const std::string& path, bool useGlyphs) {
+    std::unique_ptr<FrameSource> source = openRecordedFrames(path);
+    if (!source) {
+        std::fprintf(stderr, "No frames in %s\n", path.c_str());
+        return 1;
+    }
+
+    struct RegionState {
+        OcrPreprocessor preprocessor;
+        TextBoundsTracker bounds;
+        FrameChangeDetector changes;
+    };
+    std::map<std::string, RegionState> states;
+    GlyphRecognizer glyphs;
+    std::vector<long long> latencies[StageCount];
+    size_t frames = 0;
+    size_t reads = 0;
+    size_t unchanged = 0;
+    ReadCounts counts;
+
+    std::printf("# ocrBench\treplay=%s\tglyphs=%s\n", path.c_str(), useGlyphs ? "on" : "off");
+    auto replayStarted = BenchClock::now();
+    Frame frame;
+    while (source->next(frame)) {
+        auto started = BenchClock::now();
+        cv::Rect whole(0, 0, frame.image.cols, frame.image.rows);
+        std::vector<FrameRegion> regions = frame.regions;
+        if (regions.empty()) {
+            regions.push_back({ "", whole });
+        }
+        for (const FrameRegion& region : regions) {
+            cv::Mat image = frame.image(region.area & whole);
+            RegionState& state = states[region.name];
+
+            auto stageStarted = BenchClock::now();
+            cv::Rect area = state.bounds.searchArea(image.size());
+            cv::Mat processed = state.preprocessor.process(image(area));
+            latencies[Preprocess].push_back(microsSince(stageStarted));
+            stageStarted = BenchClock::now();
+            cv::Rect text;
+            if (!state.bounds.locate(processed, area, text)) {
+                area = cv::Rect(0, 0, image.cols, image.rows);
+                processed = state.preprocessor.process(image);
+                state.bounds.locate(processed, area, text);
+            }
+            processed = processed(text);
+            latencies[Bounds].push_back(microsSince(stageStarted));
+
+            if (state.changes.isUnchanged(processed)) {
+                ++unchanged;
+                continue;
+            }
+            std::string got = withoutSpaces(readText(processed, glyphs, useGlyphs, latencies, counts));
+            ++reads;
+            std::printf("frame\t%zu\t%s\t%lld\t%s\t%s\n", frames, frame.label.c_str(), static_cast<long long>(frame.timestamp.count()),
+                        region.name.empty() ? "main" : region.name.c_str(), got.c_str());
+        }
+        latencies[Total].push_back(microsSince(started));
+        ++frames;
+    }
+    double seconds = std::max<long long>(microsSince(replayStarted), 1) / 1e6;
+
+    std::printf("summary\tframes\t%zu\n", frames);
+    std::printf("summary\tregion_reads\t%zu\n", reads);
+    std::printf("summary\tunchanged_skipped\t%zu\n", unchanged);
+    std::printf("summary\tglyph_reads\t%zu\n", counts.glyphReads);
+    std::printf("summary\tglyph_corrections\t%zu\n", counts.glyphCorrections);
+    std::printf("summary\tframes_per_second\t%.1f\n", frames / seconds);
+    printLatencies(latencies);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string tessdata = std::getenv("TESSDATA_PREFIX") ? std::getenv("TESSDATA_PREFIX") : "/usr/share/tesseract-ocr/5/tessdata";
+    bool useGlyphs = true;
+    std::string corpusArg;
+    std::string replayArg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--generate" && i + 1 < argc) {
+            int count = i + 2 < argc ? std::atoi(argv[i + 2]) : 200;
+            return generateCorpus(argv[i + 1], count > 0 ? count : 200);
+        } else if (arg == "--tessdata" && i + 1 < argc) {
+            tessdata = argv[++i];
+        } else if (arg == "--tesseract-only") {
+            useGlyphs = false;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayArg = argv[++i];
+        } else {
+            corpusArg = arg;
+        }
+    }
+    if (!replayArg.empty()) {
+        return ocrEngines.init(tessdata, "eng", 1) ? replayRecording(replayArg, useGlyphs) : 1;
+    }
+    if (corpusArg.empty()) {
+        std::fprintf(stderr, "usage: %s [--tessdata dir] [--tesseract-only] corpus\n       %s [--tessdata dir] [--tesseract-only] --replay dir|video\n"
+                             "       %s --generate corpus [count]\n", argv[0], argv[0], argv[0]);
+        return 2;
+    }
+
+    fs::path corpus(corpusArg);
+    std::vector<Sample> samples = loadLabels(corpus);
+    if (samples.empty()) {
+        std::fprintf(stderr, "No samples in %s\n", (corpus / "labels.tsv").string().c_str());
+        return 1;
+    }
+    if (!ocrEngines.init(tessdata, "eng", 1)) {
+        return 1;
+    }
+
+    GlyphRecognizer glyphs;
+    std::vector<long long> latencies[StageCount];
+    Score overall;
+    std::map<std::string, Score> categories;
+    std::vector<std::string> misses;
+    ReadCounts counts;
+
+    for (const Sample& sample : samples) {
+        cv::Mat image = cv::imread((corpus / sample.path).string(), cv::IMREAD_COLOR);
+        if (image.empty()) {
+            std::fprintf(stderr, "Cannot read %s\n", sample.path.c_str());
+            continue;
+        }
+
+        // Each crop is a fresh region, as on the first frame after a selection
+        auto started = BenchClock::now();
+        auto stageStarted = started;
+        OcrPreprocessor preprocessor;
+        cv::Mat binary = preprocessor.process(image);
+        latencies[Preprocess].push_back(microsSince(stageStarted));
+
+        stageStarted = BenchClock::now();
+        TextBoundsTracker bounds;
+        cv::Rect text;
+        bounds.locate(binary, cv::Rect(0, 0, image.cols, image.rows), text);
+        binary = binary(text);
+        latencies[Bounds].push_back(microsSince(stageStarted));
+
+        std::string got = withoutSpaces(readText(binary, glyphs, useGlyphs, latencies, counts));
+        latencies[Total].push_back(microsSince(started));
+
+        size_t edits = editDistance(sample.expected, got);
+        for (Score* score : { &overall, &categories[sample.category] }) {
+            ++score->samples;
+            score->exact += edits == 0;
+            score->edits += edits;
+            score->characters += sample.expected.size();
+        }
+        if (edits != 0) {
+            misses.push_back("miss\t" + sample.path + "\t" + sample.expected + "\t" + got);
+        }
+    }
+
+    auto printScore = [](const std::string& prefix, const Score& score) {
+        std::printf("%s\tsamples\t%zu\n", prefix.c_str(), score.samples);
+        std::printf("%s\texact_match\t%.4f\n", prefix.c_str(), score.samples ? static_cast<double>(score.exact) / score.samples : 0.0);
+        std::printf("%s\tcer\t%.4f\n", prefix.c_str(), score.characters ? static_cast<double>(score.edits) / score.characters : 0.0);
+    };
+
+    std::printf("# ocrBench\tcorpus=%s\tglyphs=%s\n", corpus.generic_string().c_str(), useGlyphs ? "on" : "off");
+    printScore("summary", overall);
+    std::printf("summary\tglyph_reads\t%zu\n", counts.glyphReads);
+    std::printf("summary\tglyph_corrections\t%zu\n", counts.glyphCorrections);
+    printLatencies(latencies);
+    for (const auto& [name, score] : categories) {
+        printScore("category\t" + name, score);
+    }
+    for (const std::string& miss : misses) {
+        std::printf("%s\n", miss.c_str());
+    }
+    return 0;
+}
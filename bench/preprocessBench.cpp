@@ -0,0 +1,56 @@
+// Preprocessing microbenchmark: the fused gray+histogram kernel with an
+// in-place threshold against OpenCV's cvtColor + THRESH_OTSU, in ns/pixel.
+//   make bench && build/bench/preprocessBench [iterations]
+#include "../imagePreprocess.h"
+//=====================//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/imgproc.hpp>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Dark HUD-like background with bright digit-sized blocks and a little noise
+static cv::Mat makeFrame(int width, int height) {
+    cv::Mat frame(height, width, CV_8UC4);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(60));
+    for (int x = 4; x + 10 < width; x += 14) {
+        cv::rectangle(frame, cv::Rect(x, height / 4, 9, height / 2), cv::Scalar(230, 230, 230, 255), cv::FILLED);
+    }
+    return frame;
+}
+
+template <typename Fn>
+static double nsPerPixel(const cv::Mat& frame, int iterations, Fn&& fn) {
+    fn(); // warm-up, and the first call is allowed to allocate
+    auto started = BenchClock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(BenchClock::now() - started).count();
+    return elapsed / iterations / static_cast<double>(frame.total());
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    const cv::Size sizes[] = { { 64, 24 }, { 200, 40 }, { 640, 120 }, { 1920, 1080 } };
+
+    std::printf("%-11s %12s %12s %8s %s\n", "size", "fused ns/px", "opencv ns/px", "speedup", "mismatched px");
+    for (const cv::Size& size : sizes) {
+        cv::Mat frame = makeFrame(size.width, size.height);
+
+        OcrPreprocessor preprocessor;
+        cv::Mat fused;
+        double fusedNs = nsPerPixel(frame, iterations, [&] { fused = preprocessor.process(frame); });
+
+        cv::Mat gray, reference;
+        double opencvNs = nsPerPixel(frame, iterations, [&] {
+            cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+            cv::threshold(gray, reference, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+        });
+
+        std::printf("%5dx%-5d %12.3f %12.3f %7.2fx %d\n", size.width, size.height, fusedNs, opencvNs, opencvNs / fusedNs,
+                    cv::countNonZero(fused != reference));
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Number tokenizer throughput against the std::regex digit-run extraction it
+// replaced, over OCR-like lines ("HP 1,234/2,000", "-12.5k", ...).
+//   make bench && build/bench/tokenizerBench [megabytes]
+#include "../numberTokens.h"
+//=====================//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+#include <string>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 16;
+    const char* const lines[] = { "1234\n", "HP 1,234/2,000\n", "-12.5k\n", "ammo: 30 / 120\n", "Gold 1.5M\n", "x-5 (10-20)\n" };
+
+    std::string text;
+    for (size_t i = 0; text.size() < (megabytes << 20); ++i) {
+        text += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+    }
+
+    // One OCR line per call, into a reused vector, as the search stage does
+    std::vector<std::string_view> views;
+    for (size_t start = 0; start < text.size();) {
+        size_t end = text.find('\n', start) + 1;
+        views.emplace_back(text.data() + start, end - start);
+        start = end;
+    }
+    std::vector<NumberToken> tokens;
+    size_t count = 0;
+    auto started = BenchClock::now();
+    for (std::string_view line : views) {
+        count += tokenizeNumbers(line, tokens);
+    }
+    double tokenizerSeconds = std::chrono::duration<double>(BenchClock::now() - started).count();
+
+    // The old path, built once here rather than per call, which only flatters it
+    const std::regex numberPattern(R"(\d+)");
+    size_t regexCount = 0;
+    std::string regexSlice = text.substr(0, std::min<size_t>(text.size(), 1 << 20));
+    started = BenchClock::now();
+    for (std::sregex_iterator i(regexSlice.begin(), regexSlice.end(), numberPattern), end; i != end; ++i) {
+        regexCount += std::stoi(i->str()) >= 0;
+    }
+    double regexSeconds = std::chrono::duration<double>(BenchClock::now() - started).count();
+
+    double tokenizerRate = text.size() / tokenizerSeconds / 1e9;
+    double regexRate = regexSlice.size() / regexSeconds / 1e9;
+    std::printf("tokenizer: %zu tokens in %zu bytes, %.3f GB/s\n", count, text.size(), tokenizerRate);
+    std::printf("regex:     %zu digit runs in %zu bytes, %.3f GB/s\n", regexCount, regexSlice.size(), regexRate);
+    std::printf("speedup:   %.1fx\n", tokenizerRate / regexRate);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "candidateSet.h"
+//=====================//
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+enum class SetOp { Intersect, Unite, Subtract };
+
+// Below this many inputs the threads cost more than the merge itself
+static const size_t kParallelThreshold = 1 << 20;
+
+// A slice whose address span is under this many bits per entry is combined as
+// bitmaps: scans of common values hit nearly every few bytes of a heap, and a
+// word-wide AND/OR/ANDNOT beats a branchy merge there
+static const size_t kDenseBitsPerEntry = 16;
+// Intersections where one side is this many times larger gallop through it
+static const size_t kGallopRatio = 32;
+
+using CandidateIt = std::vector<uintptr_t>::const_iterator;
+
+static void setBits(std::vector<uint64_t>& bits, CandidateIt begin, CandidateIt end, uintptr_t low) {
+    for (CandidateIt it = begin; it != end; ++it) {
+        uintptr_t offset = *it - low;
+        bits[offset >> 6] |= uint64_t{ 1 } << (offset & 63);
+    }
+}
+
+static void combineDense(SetOp op, CandidateIt aBegin, CandidateIt aEnd, CandidateIt bBegin, CandidateIt bEnd, uintptr_t low,
+                         uintptr_t high, std::vector<uintptr_t>& out) {
+    size_t words = static_cast<size_t>((high - low) >> 6) + 1;
+    std::vector<uint64_t> bits(words, 0);
+    std::vector<uint64_t> other(words, 0);
+    setBits(bits, aBegin, aEnd, low);
+    setBits(other, bBegin, bEnd, low);
+
+    // Separate loops per operation so each one vectorizes
+    uint64_t* left = bits.data();
+    const uint64_t* right = other.data();
+    size_t count = 0;
+    switch (op) {
+        case SetOp::Intersect:
+            for (size_t w = 0; w < words; ++w) {
+                left[w] &= right[w];
+            }
+            break;
+        case SetOp::Unite:
+            for (size_t w = 0; w < words; ++w) {
+                left[w] |= right[w];
+            }
+            break;
+        case SetOp::Subtract:
+            for (size_t w = 0; w < words; ++w) {
+                left[w] &= ~right[w];
+            }
+            break;
+    }
+    for (size_t w = 0; w < words; ++w) {
+        count += std::popcount(left[w]);
+    }
+
+    out.reserve(out.size() + count);
+    for (size_t w = 0; w < words; ++w) {
+        for (uint64_t word = left[w]; word; word &= word - 1) {
+            out.push_back(low + (static_cast<uintptr_t>(w) << 6) + std::countr_zero(word));
+        }
+    }
+}
+
+// Each element of the small side is found by doubling steps from the last
+// match, then a binary search, so the large side is mostly skipped
+static void intersectGalloping(CandidateIt smallBegin, CandidateIt smallEnd, CandidateIt largeBegin, CandidateIt largeEnd,
+                               std::vector<uintptr_t>& out) {
+    out.reserve(out.size() + std::distance(smallBegin, smallEnd));
+    CandidateIt position = largeBegin;
+    for (CandidateIt it = smallBegin; it != smallEnd && position != largeEnd; ++it) {
+        size_t step = 1;
+        CandidateIt bound = position;
+        while (std::distance(bound, largeEnd) > static_cast<std::ptrdiff_t>(step) && *(bound + step) < *it) {
+            bound += step;
+            step <<= 1;
+        }
+        CandidateIt limit = std::distance(bound, largeEnd) > static_cast<std::ptrdiff_t>(step) ? bound + step + 1 : largeEnd;
+        position = std::lower_bound(bound, limit, *it);
+        if (position != largeEnd && *position == *it) {
+            out.push_back(*it);
+        }
+    }
+}
+
+static void mergeSlice(SetOp op, CandidateIt aBegin, CandidateIt aEnd, CandidateIt bBegin, CandidateIt bEnd, std::vector<uintptr_t>& out) {
+    size_t aCount = static_cast<size_t>(std::distance(aBegin, aEnd));
+    size_t bCount = static_cast<size_t>(std::distance(bBegin, bEnd));
+    if (aCount > 0 && bCount > 0) {
+        uintptr_t low = std::min(*aBegin, *bBegin);
+        uintptr_t high = std::max(*(aEnd - 1), *(bEnd - 1));
+        if (op == SetOp::Intersect && aCount * kGallopRatio < bCount) {
+            intersectGalloping(aBegin, aEnd, bBegin, bEnd, out);
+            return;
+        }
+        if (op == SetOp::Intersect && bCount * kGallopRatio < aCount) {
+            intersectGalloping(bBegin, bEnd, aBegin, aEnd, out);
+            return;
+        }
+        if ((high - low) / kDenseBitsPerEntry < aCount + bCount) {
+            combineDense(op, aBegin, aEnd, bBegin, bEnd, low, high, out);
+            return;
+        }
+    }
+
+    auto sink = std::back_inserter(out);
+    switch (op) {
+        case SetOp::Intersect:
+            out.reserve(std::min(std::distance(aBegin, aEnd), std::distance(bBegin, bEnd)));
+            std::set_intersection(aBegin, aEnd, bBegin, bEnd, sink);
+            break;
+        case SetOp::Unite:
+            out.reserve(std::distance(aBegin, aEnd) + std::distance(bBegin, bEnd));
+            std::set_union(aBegin, aEnd, bBegin, bEnd, sink);
+            break;
+        case SetOp::Subtract:
+            out.reserve(std::distance(aBegin, aEnd));
+            std::set_difference(aBegin, aEnd, bBegin, bEnd, sink);
+            break;
+    }
+}
+
+// Splits the address space into value ranges taken from the larger input, so
+// each worker merges the matching slices of both sets independently and the
+// per-worker outputs concatenate back into sorted order.
+static std::vector<uintptr_t> combineCandidates(SetOp op, const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b) {
+    std::vector<uintptr_t> result;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    if (a.size() + b.size() < kParallelThreshold || workers == 1) {
+        mergeSlice(op, a.begin(), a.end(), b.begin(), b.end(), result);
+        return result;
+    }
+
+    const std::vector<uintptr_t>& larger = a.size() >= b.size() ? a : b;
+    std::vector<uintptr_t> splitters;
+    for (size_t w = 1; w < workers; ++w) {
+        splitters.push_back(larger[larger.size() * w / workers]);
+    }
+
+    std::vector<std::vector<uintptr_t>> partial(workers);
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            CandidateIt aBegin = w == 0 ? a.begin() : std::lower_bound(a.begin(), a.end(), splitters[w - 1]);
+            CandidateIt aEnd = w == workers - 1 ? a.end() : std::lower_bound(a.begin(), a.end(), splitters[w]);
+            CandidateIt bBegin = w == 0 ? b.begin() : std::lower_bound(b.begin(), b.end(), splitters[w - 1]);
+            CandidateIt bEnd = w == workers - 1 ? b.end() : std::lower_bound(b.begin(), b.end(), splitters[w]);
+            mergeSlice(op, aBegin, aEnd, bBegin, bEnd, partial[w]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t total = 0;
+    for (const auto& slice : partial) {
+        total += slice.size();
+    }
+    result.reserve(total);
+    for (const auto& slice : partial) {
+        result.insert(result.end(), slice.begin(), slice.end());
+    }
+    return result;
+}
+
+void normalizeCandidates(std::vector<uintptr_t>& candidates) {
+    if (!std::is_sorted(candidates.begin(), candidates.end())) {
+        std::sort(candidates.begin(), candidates.end());
+    }
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+std::vector<uintptr_t> intersectCandidates(const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b) {
+    return combineCandidates(SetOp::Intersect, a, b);
+}
+
+std::vector<uintptr_t> uniteCandidates(const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b) {
+    return combineCandidates(SetOp::Unite, a, b);
+}
+
+std::vector<uintptr_t> subtractCandidates(const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b) {
+    return combineCandidates(SetOp::Subtract, a, b);
+}
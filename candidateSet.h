@@ -0,0 +1,19 @@
+#ifndef CANDIDATESET_H
+#define CANDIDATESET_H
+
+#include <vector>
+#include <stdint.h>
+
+// Set algebra on scan results. Inputs must be sorted and free of duplicates,
+// which is what the scanners and refiners already produce; use
+// normalizeCandidates on anything assembled by hand. Large inputs are split
+// into address ranges merged in parallel; a range where the hits are dense is
+// combined as bitmaps, and a lopsided intersection gallops through the larger
+// side instead of merging.
+void normalizeCandidates(std::vector<uintptr_t>& candidates);
+
+std::vector<uintptr_t> intersectCandidates(const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b);
+std::vector<uintptr_t> uniteCandidates(const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b);
+std::vector<uintptr_t> subtractCandidates(const std::vector<uintptr_t>& a, const std::vector<uintptr_t>& b);
+
+#endif
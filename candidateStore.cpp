@@ -0,0 +1,192 @@
+#include "candidateStore.h"
+#include "errorHandler.h"
+//=====================//
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const size_t kMergeBlockEntries = 8192; // 64 KiB of addresses per run cursor
+static std::atomic<unsigned> spillFileCounter{ 0 };
+
+#ifdef _WIN32
+#define SPILL_SEEK _fseeki64
+#else
+#define SPILL_SEEK fseeko
+#endif
+
+CandidateStore::CandidateStore(size_t budget) : budgetBytes(budget) {}
+
+CandidateStore::~CandidateStore() {
+    closeSpillFile();
+}
+
+CandidateStore::CandidateStore(CandidateStore&& other) noexcept
+    : budgetBytes(other.budgetBytes), buffer(std::move(other.buffer)), spillFile(other.spillFile),
+      spillPath(std::move(other.spillPath)), runs(std::move(other.runs)), total(other.total) {
+    other.spillFile = nullptr;
+    other.total = 0;
+    other.runs.clear();
+}
+
+CandidateStore& CandidateStore::operator=(CandidateStore&& other) noexcept {
+    if (this != &other) {
+        closeSpillFile();
+        budgetBytes = other.budgetBytes;
+        buffer = std::move(other.buffer);
+        spillFile = other.spillFile;
+        spillPath = std::move(other.spillPath);
+        runs = std::move(other.runs);
+        total = other.total;
+        other.spillFile = nullptr;
+        other.total = 0;
+        other.runs.clear();
+    }
+    return *this;
+}
+
+void CandidateStore::closeSpillFile() {
+    if (spillFile) {
+        std::fclose(spillFile);
+        spillFile = nullptr;
+        std::error_code ec;
+        fs::remove(spillPath, ec);
+    }
+}
+
+void CandidateStore::push(uintptr_t address) {
+    buffer.push_back(address);
+    ++total;
+    if (buffer.size() * sizeof(uintptr_t) >= budgetBytes) {
+        spillBuffer();
+    }
+}
+
+void CandidateStore::spillBuffer() {
+    if (!spillFile) {
+        std::error_code ec;
+        fs::path dir = fs::temp_directory_path(ec);
+        spillPath = (dir / ("candidates_" + std::to_string(spillFileCounter++) + ".bin")).string();
+        spillFile = std::fopen(spillPath.c_str(), "w+b");
+        if (!spillFile) {
+            // Better to go over budget than to lose candidates
+            LOG_WARNING("Failed to open candidate spill file " + spillPath + "; keeping candidates in memory.");
+            budgetBytes = SIZE_MAX;
+            return;
+        }
+    }
+
+    std::sort(buffer.begin(), buffer.end());
+    SPILL_SEEK(spillFile, 0, SEEK_END);
+    long long offset = 0;
+    for (const auto& run : runs) {
+        offset += static_cast<long long>(run.count * sizeof(uintptr_t));
+    }
+    if (std::fwrite(buffer.data(), sizeof(uintptr_t), buffer.size(), spillFile) != buffer.size()) {
+        LOG_WARNING("Short write to candidate spill file " + spillPath + "; keeping candidates in memory.");
+        budgetBytes = SIZE_MAX;
+        return;
+    }
+    runs.push_back({ offset, buffer.size() });
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+void CandidateStore::clear() {
+    closeSpillFile();
+    buffer.clear();
+    buffer.shrink_to_fit();
+    runs.clear();
+    total = 0;
+}
+
+void CandidateStore::forEachSorted(const std::function<void(const uintptr_t*, size_t)>& onBatch) {
+    std::sort(buffer.begin(), buffer.end());
+    if (runs.empty()) {
+        for (size_t i = 0; i < buffer.size(); i += kMergeBlockEntries) {
+            onBatch(buffer.data() + i, std::min(kMergeBlockEntries, buffer.size() - i));
+        }
+        return;
+    }
+
+    struct RunCursor {
+        long long next;
+        size_t remaining;
+        std::vector<uintptr_t> block;
+        size_t pos = 0;
+    };
+    std::vector<RunCursor> cursors;
+    for (const auto& run : runs) {
+        cursors.push_back({ run.offset, run.count, {} });
+    }
+
+    auto refill = [&](RunCursor& cursor) {
+        size_t count = std::min(kMergeBlockEntries, cursor.remaining);
+        cursor.block.resize(count);
+        cursor.pos = 0;
+        if (count == 0) {
+            return;
+        }
+        SPILL_SEEK(spillFile, cursor.next, SEEK_SET);
+        size_t got = std::fread(cursor.block.data(), sizeof(uintptr_t), count, spillFile);
+        cursor.block.resize(got);
+        cursor.next += static_cast<long long>(got * sizeof(uintptr_t));
+        cursor.remaining = got == count ? cursor.remaining - count : 0;
+    };
+
+    // Source index == cursors.size() is the in-memory buffer
+    using HeapEntry = std::pair<uintptr_t, size_t>;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        refill(cursors[i]);
+        if (!cursors[i].block.empty()) {
+            heap.push({ cursors[i].block[0], i });
+        }
+    }
+    size_t bufferPos = 0;
+    if (!buffer.empty()) {
+        heap.push({ buffer[0], cursors.size() });
+    }
+
+    std::vector<uintptr_t> batch;
+    batch.reserve(kMergeBlockEntries);
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        batch.push_back(top.first);
+        if (batch.size() == kMergeBlockEntries) {
+            onBatch(batch.data(), batch.size());
+            batch.clear();
+        }
+
+        if (top.second == cursors.size()) {
+            if (++bufferPos < buffer.size()) {
+                heap.push({ buffer[bufferPos], top.second });
+            }
+            continue;
+        }
+        RunCursor& cursor = cursors[top.second];
+        if (++cursor.pos == cursor.block.size()) {
+            refill(cursor);
+        }
+        if (cursor.pos < cursor.block.size()) {
+            heap.push({ cursor.block[cursor.pos], top.second });
+        }
+    }
+    if (!batch.empty()) {
+        onBatch(batch.data(), batch.size());
+    }
+}
+
+std::vector<uintptr_t> CandidateStore::toVector() {
+    std::vector<uintptr_t> all;
+    all.reserve(total);
+    forEachSorted([&](const uintptr_t* batch, size_t count) {
+        all.insert(all.end(), batch, batch + count);
+    });
+    return all;
+}
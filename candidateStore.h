@@ -0,0 +1,58 @@
+#ifndef CANDIDATESTORE_H
+#define CANDIDATESTORE_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+static const size_t kDefaultCandidateBudget = 256ull * 1024 * 1024;
+
+// Candidate addresses held under a fixed memory budget. Once the in-memory
+// buffer reaches the budget it is sorted and appended to a temp file as a
+// run; reading back merges the runs with sequential reads, so memory use
+// stays bounded however many hits a scan produces.
+class CandidateStore {
+    struct SpillRun {
+        long long offset; // byte offset in the spill file
+        size_t count;
+    };
+
+    size_t budgetBytes;
+    std::vector<uintptr_t> buffer;
+    std::FILE* spillFile = nullptr;
+    std::string spillPath;
+    std::vector<SpillRun> runs;
+    size_t total = 0;
+
+    void spillBuffer();
+    void closeSpillFile();
+
+public:
+    explicit CandidateStore(size_t budget = kDefaultCandidateBudget);
+    ~CandidateStore();
+
+    CandidateStore(const CandidateStore&) = delete;
+    CandidateStore& operator=(const CandidateStore&) = delete;
+    CandidateStore(CandidateStore&& other) noexcept;
+    CandidateStore& operator=(CandidateStore&& other) noexcept;
+
+    void push(uintptr_t address);
+    void clear();
+    void setBudget(size_t budget) { budgetBytes = budget; }
+
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+    bool spilled() const { return !runs.empty(); }
+    size_t budget() const { return budgetBytes; }
+
+    // Unsorted view of whatever has not been spilled yet
+    const std::vector<uintptr_t>& inMemory() const { return buffer; }
+
+    // Every address in ascending order, delivered in batches
+    void forEachSorted(const std::function<void(const uintptr_t*, size_t)>& onBatch);
+    std::vector<uintptr_t> toVector();
+};
+
+#endif
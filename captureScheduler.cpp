@@ -0,0 +1,68 @@
+#include "captureScheduler.h"
+//=====================//
+#include <algorithm>
+#include <vector>
+
+CaptureScheduler::CaptureScheduler(const CaptureSchedulerConfig& settings)
+    : config(settings), interval(settings.minInterval) {}
+
+FrameTiming CaptureScheduler::frameCaptured(CaptureClock::time_point now) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    FrameTiming timing;
+    timing.captured = now;
+    timing.previousCapture = lastCapture;
+    lastCapture = now;
+    return timing;
+}
+
+std::chrono::milliseconds CaptureScheduler::frameFinished(const FrameTiming& timing, bool valueChanged, size_t scanBacklog,
+                                                          CaptureClock::time_point now) {
+    using std::chrono::milliseconds;
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+
+    if (valueChanged) {
+        if (timing.previousCapture != CaptureClock::time_point{}) {
+            latencies.push_back(std::chrono::duration_cast<milliseconds>(now - timing.previousCapture));
+            if (latencies.size() > kLatencyHistory) {
+                latencies.pop_front();
+            }
+        }
+        interval = config.minInterval;
+    } else {
+        interval = milliseconds(static_cast<long long>(interval.count() * config.backoffFactor));
+    }
+
+    // Keep work / (work + sleep) under the CPU budget
+    milliseconds work = std::chrono::duration_cast<milliseconds>(timing.work);
+    if (config.cpuBudget > 0.0 && config.cpuBudget < 1.0) {
+        milliseconds budgetFloor(static_cast<long long>(work.count() * (1.0 - config.cpuBudget) / config.cpuBudget));
+        interval = std::max(interval, budgetFloor);
+    }
+    // Frames that only queue behind unfinished scans tell us nothing new
+    if (scanBacklog > 0) {
+        interval = std::max(interval, milliseconds(config.minInterval.count() * static_cast<long long>(scanBacklog + 1)));
+    }
+
+    interval = std::clamp(interval, config.minInterval, config.maxInterval);
+    return interval;
+}
+
+std::chrono::milliseconds CaptureScheduler::currentInterval() const {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    return interval;
+}
+
+CaptureLatencyStats CaptureScheduler::latencyStats() const {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    CaptureLatencyStats stats;
+    if (latencies.empty()) {
+        return stats;
+    }
+    std::vector<std::chrono::milliseconds> sorted(latencies.begin(), latencies.end());
+    std::sort(sorted.begin(), sorted.end());
+    stats.samples = sorted.size();
+    stats.p50 = sorted[(sorted.size() - 1) / 2];
+    stats.p95 = sorted[(sorted.size() - 1) * 95 / 100];
+    stats.max = sorted.back();
+    return stats;
+}
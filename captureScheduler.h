@@ -0,0 +1,63 @@
+#ifndef CAPTURESCHEDULER_H
+#define CAPTURESCHEDULER_H
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <stddef.h>
+
+using CaptureClock = std::chrono::steady_clock;
+
+struct CaptureSchedulerConfig {
+    std::chrono::milliseconds minInterval{ 100 };
+    std::chrono::milliseconds maxInterval{ 2000 };
+    double backoffFactor = 2.0;
+    double cpuBudget = 0.25; // largest fraction of one core the capture loop may keep busy
+};
+
+struct CaptureLatencyStats {
+    size_t samples = 0;
+    std::chrono::milliseconds p50{ 0 };
+    std::chrono::milliseconds p95{ 0 };
+    std::chrono::milliseconds max{ 0 };
+};
+
+// Travels with a frame: when it was captured, when the frame before it was,
+// and the stage time spent on it so far
+struct FrameTiming {
+    CaptureClock::time_point captured{};
+    CaptureClock::time_point previousCapture{}; // zero for the first frame
+    CaptureClock::duration work{ 0 };
+};
+
+// Picks the sleep before the next capture: the minimum right after the value
+// changed, growing by backoffFactor per idle frame up to the maximum, and
+// never so short that frame work would exceed the CPU budget or outrun a
+// backlog of pending scans. Frames are stamped on the capture thread and
+// finished on whichever stage is last to handle them.
+class CaptureScheduler {
+    mutable std::mutex schedulerMutex;
+    CaptureSchedulerConfig config;
+    std::chrono::milliseconds interval;
+    CaptureClock::time_point lastCapture{};
+
+    static const size_t kLatencyHistory = 256;
+    std::deque<std::chrono::milliseconds> latencies;
+
+public:
+    explicit CaptureScheduler(const CaptureSchedulerConfig& settings = CaptureSchedulerConfig());
+
+    FrameTiming frameCaptured(CaptureClock::time_point now = CaptureClock::now());
+
+    // Once the frame's reading is settled. When it changed the value, the
+    // change happened after the previous capture, so now - previousCapture is
+    // its change-to-seen latency. timing.work, summed over every stage, is
+    // what the CPU budget weighs against the interval.
+    std::chrono::milliseconds frameFinished(const FrameTiming& timing, bool valueChanged, size_t scanBacklog = 0,
+                                            CaptureClock::time_point now = CaptureClock::now());
+
+    std::chrono::milliseconds currentInterval() const;
+    CaptureLatencyStats latencyStats() const;
+};
+
+#endif
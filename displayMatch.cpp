@@ -0,0 +1,112 @@
+#include "displayMatch.h"
+//=====================//
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+struct RealInterval {
+    double low;
+    double high;
+    bool lowInclusive;
+    bool highInclusive;
+};
+
+// display = stored * scale, so /1000 is a scale of 0.001
+static const double kDisplayScales[] = { 1.0, 10.0, 100.0, 0.001 };
+static const DisplayRounding kRoundings[] = { DisplayRounding::Truncate, DisplayRounding::HalfUp, DisplayRounding::Bankers };
+
+static RealInterval displayInterval(double shown, double step, DisplayRounding mode) {
+    const double half = step / 2.0;
+    switch (mode) {
+        case DisplayRounding::Truncate:
+            if (shown > 0) return { shown, shown + step, true, false };
+            if (shown < 0) return { shown - step, shown, false, true };
+            return { -step, step, false, false };
+        case DisplayRounding::HalfUp:
+            if (shown > 0) return { shown - half, shown + half, true, false };
+            if (shown < 0) return { shown - half, shown + half, false, true };
+            return { -half, half, false, false };
+        case DisplayRounding::Bankers:
+        default: {
+            long long lastDigit = std::llround(std::fabs(shown) / step);
+            bool even = (lastDigit % 2) == 0;
+            return { shown - half, shown + half, even, even };
+        }
+    }
+}
+
+// Snap a real interval to the closed set of representable T values inside it
+template <typename T>
+static bool snapInterval(const RealInterval& in, ValueRange<T>& out) {
+    const T inf = std::numeric_limits<T>::infinity();
+    T lo = static_cast<T>(in.low);
+    T hi = static_cast<T>(in.high);
+    if (static_cast<double>(lo) < in.low || (!in.lowInclusive && static_cast<double>(lo) == in.low)) {
+        lo = std::nextafter(lo, inf);
+    }
+    if (static_cast<double>(hi) > in.high || (!in.highInclusive && static_cast<double>(hi) == in.high)) {
+        hi = std::nextafter(hi, -inf);
+    }
+    if (!std::isfinite(lo) || !std::isfinite(hi) || lo > hi) {
+        return false;
+    }
+    out = { lo, hi };
+    return true;
+}
+
+template <typename T>
+static std::vector<ValueRange<T>> buildRanges(const DisplayedNumber& shown) {
+    std::vector<ValueRange<T>> ranges;
+    const double step = std::pow(10.0, -shown.decimals);
+
+    for (double scale : kDisplayScales) {
+        for (DisplayRounding mode : kRoundings) {
+            RealInterval display = displayInterval(shown.value, step, mode);
+            double factor = shown.suffixScale / scale;
+            RealInterval stored{ display.low * factor, display.high * factor, display.lowInclusive, display.highInclusive };
+            ValueRange<T> range;
+            if (snapInterval(stored, range)) {
+                ranges.push_back(range);
+            }
+        }
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](const ValueRange<T>& a, const ValueRange<T>& b) {
+        return a.low < b.low;
+    });
+
+    std::vector<ValueRange<T>> merged;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && range.low <= std::nextafter(merged.back().high, std::numeric_limits<T>::infinity())) {
+            merged.back().high = std::max(merged.back().high, range.high);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+bool parseDisplayedNumber(const std::string& text, DisplayedNumber& out, const NumberLocale& locale) {
+    std::vector<NumberToken> tokens = tokenizeNumbers(text, locale);
+    if (tokens.empty() || tokens.front().overflow) {
+        return false;
+    }
+    const NumberToken& first = tokens.front();
+    double digits = static_cast<double>(first.mantissa) / std::pow(10.0, first.decimals);
+    out.value = first.negative ? -digits : digits;
+    out.decimals = first.decimals;
+    out.suffixScale = static_cast<double>(first.scale);
+    return true;
+}
+
+std::vector<FloatRange> buildFloatRanges(const DisplayedNumber& shown) {
+    return buildRanges<float>(shown);
+}
+
+std::vector<DoubleRange> buildDoubleRanges(const DisplayedNumber& shown) {
+    return buildRanges<double>(shown);
+}
@@ -0,0 +1,41 @@
+#ifndef DISPLAYMATCH_H
+#define DISPLAYMATCH_H
+
+#include <string>
+#include <vector>
+#include "numberTokens.h"
+
+// How a game turns the stored value into the digits it draws
+enum class DisplayRounding {
+    Truncate,   // 12.99 -> "12"
+    HalfUp,     // 12.5  -> "13" (half away from zero)
+    Bankers     // 12.5  -> "12", 13.5 -> "14"
+};
+
+// A number as the OCR read it, e.g. "1.2k" -> value 1.2, decimals 1, suffixScale 1000
+struct DisplayedNumber {
+    double value = 0.0;
+    int decimals = 0;
+    double suffixScale = 1.0;
+};
+
+// Closed interval [low, high] of stored values, already snapped to the stored type
+template <typename T>
+struct ValueRange {
+    T low;
+    T high;
+};
+
+using FloatRange = ValueRange<float>;
+using DoubleRange = ValueRange<double>;
+
+// The first number of the text, read with the locale's separators and suffixes
+bool parseDisplayedNumber(const std::string& text, DisplayedNumber& out, const NumberLocale& locale = NumberLocale());
+
+// Every stored value that would display as `shown` under any rounding mode and
+// any of the common display scales (x1, x10, x100, /1000), merged into as few
+// intervals as possible so the scanner only has to do range compares.
+std::vector<FloatRange> buildFloatRanges(const DisplayedNumber& shown);
+std::vector<DoubleRange> buildDoubleRanges(const DisplayedNumber& shown);
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef DROPOLDESTQUEUE_H
+#define DROPOLDESTQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free bounded MPMC ring (per-cell sequence numbers, after Vyukov).
+// push() never blocks: when the ring is full it pops and discards the oldest
+// item, so a slow consumer sees the newest data rather than stalling its
+// producer. pushWait() is the lossless variant for replay. A consumer facing
+// an empty ring (or pushWait facing a full one) yields briefly, then parks on
+// the changes counter, which every successful push, pop and close bumps; the
+// notify is only issued while someone is parked.
+template <typename T>
+class DropOldestQueue {
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+    std::atomic<size_t> dropped{ 0 };
+    std::atomic<bool> closed{ false };
+    std::atomic<uint32_t> changes{ 0 };
+    std::atomic<uint32_t> parked{ 0 };
+
+    static constexpr unsigned kSpinsBeforePark = 64;
+
+    void wake() {
+        changes.fetch_add(1);
+        if (parked.load() > 0) {
+            changes.notify_all();
+        }
+    }
+
+    // Registers as parked before sampling changes and retrying, so a wake()
+    // racing with the retry either lets attempt succeed or moves changes on
+    template <typename Attempt>
+    bool parkUntil(Attempt attempt) {
+        parked.fetch_add(1);
+        uint32_t seen = changes.load();
+        bool done = attempt();
+        if (!done && !closed.load()) {
+            changes.wait(seen);
+        }
+        parked.fetch_sub(1);
+        return done;
+    }
+
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t power = 2;
+        while (power < n) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+public:
+    explicit DropOldestQueue(size_t capacity) {
+        size_t size = roundUpToPowerOfTwo(capacity);
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    DropOldestQueue(const DropOldestQueue&) = delete;
+    DropOldestQueue& operator=(const DropOldestQueue&) = delete;
+
+    // Moves from item only on success
+    bool tryPush(T& item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        wake();
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (difference == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // empty
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->value);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        wake();
+        return true;
+    }
+
+    // Returns false once closed
+    bool push(T item) {
+        while (!closed.load(std::memory_order_relaxed)) {
+            if (tryPush(item)) {
+                return true;
+            }
+            T oldest;
+            if (tryPop(oldest)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return false;
+    }
+
+    bool pushWait(T item) {
+        for (unsigned spins = 0; !closed.load(std::memory_order_relaxed); ++spins) {
+            if (tryPush(item)) {
+                return true;
+            }
+            if (spins < kSpinsBeforePark) {
+                std::this_thread::yield();
+            } else if (parkUntil([&] { return tryPush(item); })) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Waits for an item; false once the queue is closed and drained
+    bool pop(T& out) {
+        for (unsigned spins = 0;; ++spins) {
+            if (tryPop(out)) {
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire)) {
+                return tryPop(out);
+            }
+            if (spins < kSpinsBeforePark) {
+                std::this_thread::yield();
+            } else if (parkUntil([&] { return tryPop(out); })) {
+                return true;
+            }
+        }
+    }
+
+    void close() {
+        closed.store(true);
+        wake();
+    }
+
+    size_t size() const {
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    size_t capacity() const { return mask + 1; }
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif
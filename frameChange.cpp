@@ -0,0 +1,62 @@
+#include "frameChange.h"
+#include "pageFingerprint.h"
+//=====================//
+#include <opencv2/imgproc.hpp>
+
+uint64_t exactFrameHash(const cv::Mat& frame) {
+    if (frame.isContinuous()) {
+        return hashPage(reinterpret_cast<const char*>(frame.data), frame.total() * frame.elemSize());
+    }
+    uint64_t hash = 0;
+    size_t rowBytes = frame.cols * frame.elemSize();
+    for (int y = 0; y < frame.rows; ++y) {
+        hash = hash * 0x9E3779B97F4A7C15ull ^ hashPage(reinterpret_cast<const char*>(frame.ptr(y)), rowBytes);
+    }
+    return hash;
+}
+
+PerceptualHash perceptualFrameHash(const cv::Mat& frame) {
+    cv::Mat cells;
+    cv::resize(frame, cells, cv::Size(kPerceptualHashWidth, kPerceptualHashHeight), 0, 0, cv::INTER_AREA);
+    if (cells.channels() > 1) {
+        cv::cvtColor(cells, cells, cells.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    }
+
+    double mean = cv::mean(cells)[0];
+    PerceptualHash hash;
+    for (int y = 0; y < kPerceptualHashHeight; ++y) {
+        const uint8_t* row = cells.ptr<uint8_t>(y);
+        for (int x = 0; x < kPerceptualHashWidth; ++x) {
+            hash[y * kPerceptualHashWidth + x] = row[x] > mean;
+        }
+    }
+    return hash;
+}
+
+bool FrameChangeDetector::isUnchanged(const cv::Mat& frame) {
+    uint64_t exact = exactFrameHash(frame);
+    PerceptualHash perceptual = perceptualFrameHash(frame);
+
+    bool sameSize = haveFrame && frame.cols == lastWidth && frame.rows == lastHeight;
+    bool same = sameSize && (exact == lastExactHash || (perceptual ^ lastPerceptualHash).count() <= toleranceBits);
+
+    if (same && consecutiveSkips < maxConsecutiveSkips) {
+        ++consecutiveSkips;
+        ++skipped;
+        return true;
+    }
+
+    lastWidth = frame.cols;
+    lastHeight = frame.rows;
+    lastExactHash = exact;
+    lastPerceptualHash = perceptual;
+    haveFrame = true;
+    consecutiveSkips = 0;
+    ++passed;
+    return false;
+}
+
+void FrameChangeDetector::reset() {
+    haveFrame = false;
+    consecutiveSkips = 0;
+}
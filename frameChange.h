@@ -0,0 +1,47 @@
+#ifndef FRAMECHANGE_H
+#define FRAMECHANGE_H
+
+#include <bitset>
+#include <stdint.h>
+#include <stddef.h>
+#include <opencv2/core.hpp>
+
+static const int kPerceptualHashWidth = 32;
+static const int kPerceptualHashHeight = 8;
+using PerceptualHash = std::bitset<kPerceptualHashWidth * kPerceptualHashHeight>;
+
+// Decides whether a preprocessed ROI is the same frame as the last one that
+// was recognized. A byte-exact hash catches the common case; a coarse
+// perceptual hash (cell averages against the frame mean) lets a few pixels of
+// capture noise through without re-running OCR. Every maxConsecutiveSkips
+// skipped frames one is passed anyway, in case a small glyph change hid
+// under the tolerance.
+class FrameChangeDetector {
+    int lastWidth = 0;
+    int lastHeight = 0;
+    uint64_t lastExactHash = 0;
+    PerceptualHash lastPerceptualHash;
+    bool haveFrame = false;
+
+    size_t toleranceBits;
+    size_t maxConsecutiveSkips;
+    size_t consecutiveSkips = 0;
+    size_t skipped = 0;
+    size_t passed = 0;
+
+public:
+    explicit FrameChangeDetector(size_t tolerance = 1, size_t maxSkips = 10)
+        : toleranceBits(tolerance), maxConsecutiveSkips(maxSkips) {}
+
+    // True if frame matches the last passed frame and recognition can be skipped
+    bool isUnchanged(const cv::Mat& frame);
+    void reset();
+
+    size_t skippedFrames() const { return skipped; }
+    size_t passedFrames() const { return passed; }
+};
+
+uint64_t exactFrameHash(const cv::Mat& frame);
+PerceptualHash perceptualFrameHash(const cv::Mat& frame);
+
+#endif
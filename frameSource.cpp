@@ -0,0 +1,235 @@
+#include "frameSource.h"
+#ifdef _WIN32
+#include "shareInfo.h"
+#include "errorHandler.h"
+#endif
+//=====================//
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+#include <opencv2/imgcodecs.hpp>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static bool isNumericStem(const std::string& stem) {
+    return !stem.empty() && std::all_of(stem.begin(), stem.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+
+ImageDirectorySource::ImageDirectorySource(const std::string& directory) {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (entry.is_regular_file() && extension == ".png") {
+            files.push_back(entry.path().string());
+        }
+    }
+
+    // Numeric names sort by value so 10.png follows 9.png
+    std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+        std::string stemA = fs::path(a).stem().string();
+        std::string stemB = fs::path(b).stem().string();
+        if (isNumericStem(stemA) && isNumericStem(stemB) && stemA.size() != stemB.size()) {
+            return stemA.size() < stemB.size();
+        }
+        return a < b;
+    });
+
+    fs::file_time_type firstWrite{};
+    bool haveFirstWrite = false;
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::string stem = fs::path(files[i]).stem().string();
+        if (isNumericStem(stem) && stem.size() < 19) {
+            timestamps.push_back(std::chrono::milliseconds(std::stoll(stem)));
+            continue;
+        }
+        fs::file_time_type written = fs::last_write_time(files[i], ec);
+        if (!haveFirstWrite) {
+            firstWrite = written;
+            haveFirstWrite = true;
+        }
+        timestamps.push_back(std::max(std::chrono::milliseconds(0), std::chrono::duration_cast<std::chrono::milliseconds>(written - firstWrite)));
+    }
+}
+
+bool ImageDirectorySource::next(Frame& frame) {
+    while (position < files.size()) {
+        size_t index = position++;
+        frame.image = cv::imread(files[index], cv::IMREAD_COLOR);
+        if (frame.image.empty()) {
+            continue; // unreadable file; move on to the next one
+        }
+        frame.timestamp = timestamps[index];
+        frame.label = fs::path(files[index]).filename().string();
+        return true;
+    }
+    return false;
+}
+
+VideoFileSource::VideoFileSource(const std::string& file) : capture(file), path(file) {}
+
+bool VideoFileSource::next(Frame& frame) {
+    if (!capture.isOpened()) {
+        return false;
+    }
+    // POS_MSEC reports the position of the frame about to be decoded
+    double positionMs = capture.get(cv::CAP_PROP_POS_MSEC);
+    if (!capture.read(frame.image) || frame.image.empty()) {
+        return false;
+    }
+    frame.timestamp = std::chrono::milliseconds(static_cast<long long>(positionMs));
+    frame.label = fs::path(path).filename().string() + "#" + std::to_string(frameIndex++);
+    return true;
+}
+
+std::unique_ptr<FrameSource> openRecordedFrames(const std::string& path) {
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        auto source = std::make_unique<ImageDirectorySource>(path);
+        if (source->size() == 0) {
+            return nullptr;
+        }
+        return source;
+    }
+    auto source = std::make_unique<VideoFileSource>(path);
+    if (!source->isOpen()) {
+        return nullptr;
+    }
+    return source;
+}
+
+#ifdef _WIN32
+static UINT getSystemDPI() {
+    HMODULE user32Module = LoadLibrary(TEXT("user32.dll"));
+    REGISTER_HANDLE(user32Module);
+    if (user32Module) {
+        try {
+            auto GetDpiForSystem = reinterpret_cast<UINT(WINAPI*)()>(
+                GetProcAddress(user32Module, "GetDpiForSystem"));
+            if (GetDpiForSystem) {
+                UINT dpi = GetDpiForSystem();
+                FreeLibrary(user32Module);
+                UNREGISTER_HANDLE(user32Module);
+                return dpi;
+            }
+        }
+        catch (...) {
+            FreeLibrary(user32Module);
+            UNREGISTER_HANDLE(user32Module);
+            return 96;
+        }
+        FreeLibrary(user32Module);
+        UNREGISTER_HANDLE(user32Module);
+    }
+    return 96;
+}
+
+// A screen rectangle's place inside a capture of `bounds`, clipped to the image
+static cv::Rect areaInCapture(const RECT& region, const RECT& bounds, float scaleFactor, const cv::Mat& image) {
+    cv::Rect area(static_cast<int>((region.left - bounds.left) * scaleFactor), static_cast<int>((region.top - bounds.top) * scaleFactor),
+                  static_cast<int>((region.right - region.left) * scaleFactor), static_cast<int>((region.bottom - region.top) * scaleFactor));
+    return area & cv::Rect(0, 0, image.cols, image.rows);
+}
+
+bool GdiFrameSource::next(Frame& frame) {
+    RECT selected = shareInfo.getSelected();
+    if (selected.left < 0 || selected.top < 0 || selected.right <= selected.left || selected.bottom <= selected.top) {
+        LOG_INFO("No valid area selected for screen capture.");
+        return false; // No valid area selected
+    }
+
+    // One BitBlt of the bounding box costs about the same as one of the selection alone
+    std::vector<WatchedRegion> watched = shareInfo.getWatchedRegions();
+    RECT rect = selected;
+    for (const auto& region : watched) {
+        UnionRect(&rect, &rect, &region.rect);
+    }
+
+    UINT dpi = getSystemDPI();
+    float scaleFactor = dpi / 96.0f;
+
+    // Adjust for DPI scaling
+    int width = static_cast<int>((rect.right - rect.left) * scaleFactor);
+    int height = static_cast<int>((rect.bottom - rect.top) * scaleFactor);
+
+    if (width <= 0 || height <= 0) {
+        LOG_FATAL("Invalid dimensions for screen capture.");
+        return false;
+    }
+
+    // Create resources for screen capture
+    HDC hScreen = nullptr;
+    HDC hDC = nullptr;
+    HBITMAP hBitmap = nullptr;
+    cv::Mat mat;
+    REGISTER_HANDLE(hScreen);
+    REGISTER_HANDLE(hDC);
+
+    try {
+        hScreen = GetDC(NULL);
+        if (!hScreen) {
+            LOG_FATAL("Failed to get screen DC.");
+            UNREGISTER_HANDLE(hScreen);
+            throw std::runtime_error("Failed to get screen DC");
+        }
+
+        hDC = CreateCompatibleDC(hScreen);
+        if (!hDC) {
+            LOG_FATAL("Failed to create compatible DC.");
+            UNREGISTER_HANDLE(hDC);
+            throw std::runtime_error("Failed to create compatible DC");
+        }
+
+        hBitmap = CreateCompatibleBitmap(hScreen, width, height);
+        if (!hBitmap) {
+            LOG_FATAL("Failed to create bitmap.");
+            throw std::runtime_error("Failed to create bitmap");
+        }
+
+        HGDIOBJ oldObj = SelectObject(hDC, hBitmap);
+        BitBlt(hDC, 0, 0, width, height, hScreen, rect.left, rect.top, SRCCOPY);
+
+        // Get bitmap properties
+        BITMAP bmp;
+        GetObject(hBitmap, sizeof(BITMAP), &bmp);
+
+        // Reuse a free capture buffer of the right dimensions
+        mat = captures.acquire(bmp.bmHeight, bmp.bmWidth, CV_8UC4);
+        GetBitmapBits(hBitmap, bmp.bmHeight * bmp.bmWidth * 4, mat.data);
+
+        // Cleanup GDI resources
+        UNREGISTER_HANDLE(hScreen);
+        UNREGISTER_HANDLE(hDC);
+        SelectObject(hDC, oldObj);
+        DeleteObject(hBitmap);
+        DeleteDC(hDC);
+        ReleaseDC(NULL, hScreen);
+
+    }
+    catch (const std::exception& e) {
+        // Clean up in case of exception
+        if (hBitmap) DeleteObject(hBitmap);
+        if (hDC) DeleteDC(hDC);
+        if (hScreen) ReleaseDC(NULL, hScreen);
+        LOG_FATAL(std::string("Capture error: ") + e.what());
+        return false;
+    }
+
+    frame.image = mat;
+    frame.regions.clear();
+    frame.regions.push_back({ "", areaInCapture(selected, rect, scaleFactor, mat) });
+    for (const auto& region : watched) {
+        cv::Rect area = areaInCapture(region.rect, rect, scaleFactor, mat);
+        if (!area.empty()) {
+            frame.regions.push_back({ region.name, area });
+        }
+    }
+    frame.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    frame.label.clear();
+    return true;
+}
+#endif
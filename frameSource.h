@@ -0,0 +1,80 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include "imagePreprocess.h"
+
+// Where one screen region lies inside a captured frame
+struct FrameRegion {
+    std::string name; // empty for the main selection
+    cv::Rect area;    // in image pixels
+};
+
+struct Frame {
+    cv::Mat image;                      // BGRA from the screen, BGR from files
+    std::chrono::milliseconds timestamp; // since the start of the source's recording
+    std::string label;                  // file name, or empty for live capture
+    std::vector<FrameRegion> regions;   // main selection first; empty means the whole image is the main selection
+};
+
+// Where frames for the OCR path come from. Live capture paces itself to the
+// screen; file sources replay as fast as the consumer takes frames, carrying
+// the timestamps of the original recording.
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // False when no frame could be produced (capture failure or end of a recording)
+    virtual bool next(Frame& frame) = 0;
+    virtual bool isLive() const { return false; }
+};
+
+// PNG files of a directory in name order. A file named after a number
+// ("1532.png") takes that as its millisecond timestamp; otherwise frames are
+// spaced by the files' modification times.
+class ImageDirectorySource : public FrameSource {
+    std::vector<std::string> files;
+    std::vector<std::chrono::milliseconds> timestamps;
+    size_t position = 0;
+
+public:
+    explicit ImageDirectorySource(const std::string& directory);
+    bool next(Frame& frame) override;
+    size_t size() const { return files.size(); }
+};
+
+// A recorded video decoded through OpenCV; timestamps are the stream's own
+class VideoFileSource : public FrameSource {
+    cv::VideoCapture capture;
+    std::string path;
+    size_t frameIndex = 0;
+
+public:
+    explicit VideoFileSource(const std::string& file);
+    bool next(Frame& frame) override;
+    bool isOpen() const { return capture.isOpened(); }
+};
+
+#ifdef _WIN32
+// The selected screen rectangle plus every watched region, captured through
+// GDI at the system DPI in one BitBlt of their bounding box
+class GdiFrameSource : public FrameSource {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    MatRing captures; // recycled once the preprocess stage lets go of a frame
+
+public:
+    bool next(Frame& frame) override;
+    bool isLive() const override { return true; }
+};
+#endif
+
+// A directory becomes an ImageDirectorySource, anything else a VideoFileSource;
+// nullptr if neither yields frames
+std::unique_ptr<FrameSource> openRecordedFrames(const std::string& path);
+
+#endif
@@ -0,0 +1,228 @@
+#include "glyphRecognizer.h"
+#include "imagePreprocess.h"
+//=====================//
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <opencv2/imgproc.hpp>
+
+static const float kMaxAspectRatio = 1.6f; // templates further off in width/height than this are not compared
+static const int kMinGlyphArea = 2;
+
+struct GlyphBox {
+    int left;
+    int right; // exclusive
+};
+
+// Connected components in left-to-right order, with pieces that overlap
+// horizontally (a glyph broken by thresholding) merged into one
+static std::vector<GlyphBox> segmentGlyphs(const cv::Mat& mask, int& lineTop, int& lineBottom) {
+    cv::Mat labels, stats, centroids;
+    int count = cv::connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+
+    std::vector<GlyphBox> boxes;
+    lineTop = mask.rows;
+    lineBottom = 0;
+    for (int i = 1; i < count; ++i) { // 0 is the background
+        if (stats.at<int>(i, cv::CC_STAT_AREA) < kMinGlyphArea) {
+            continue;
+        }
+        int left = stats.at<int>(i, cv::CC_STAT_LEFT);
+        int top = stats.at<int>(i, cv::CC_STAT_TOP);
+        boxes.push_back({ left, left + stats.at<int>(i, cv::CC_STAT_WIDTH) });
+        lineTop = std::min(lineTop, top);
+        lineBottom = std::max(lineBottom, top + stats.at<int>(i, cv::CC_STAT_HEIGHT));
+    }
+    std::sort(boxes.begin(), boxes.end(), [](const GlyphBox& a, const GlyphBox& b) { return a.left < b.left; });
+
+    std::vector<GlyphBox> merged;
+    for (const auto& box : boxes) {
+        if (!merged.empty()) {
+            GlyphBox& last = merged.back();
+            int overlap = std::min(last.right, box.right) - std::max(last.left, box.left);
+            int narrower = std::min(last.right - last.left, box.right - box.left);
+            if (overlap * 2 > narrower) {
+                last.left = std::min(last.left, box.left);
+                last.right = std::max(last.right, box.right);
+                continue;
+            }
+        }
+        merged.push_back(box);
+    }
+    return merged;
+}
+
+static GlyphTemplate normalizeGlyph(const cv::Mat& mask, const GlyphBox& box, int lineTop, int lineBottom) {
+    GlyphTemplate glyph{};
+    int lineHeight = std::max(1, lineBottom - lineTop);
+    glyph.aspect = static_cast<float>(box.right - box.left) / lineHeight;
+
+    cv::Mat cell(kGlyphHeight, kGlyphWidth, CV_32F, glyph.pixels.data());
+    cv::Mat crop = mask(cv::Rect(box.left, lineTop, box.right - box.left, lineHeight));
+    cv::Mat scaled;
+    cv::resize(crop, scaled, cell.size(), 0, 0, cv::INTER_AREA);
+    scaled.convertTo(cell, CV_32F, 1.0 / 255.0); // writes through to glyph.pixels
+
+    float mean = std::accumulate(glyph.pixels.begin(), glyph.pixels.end(), 0.0f) / glyph.pixels.size();
+    float norm = 0.0f;
+    for (float& p : glyph.pixels) {
+        p -= mean;
+        norm += p * p;
+    }
+    norm = std::sqrt(norm);
+    glyph.flat = norm < 1e-3f;
+    if (!glyph.flat) {
+        for (float& p : glyph.pixels) {
+            p /= norm;
+        }
+    }
+    return glyph;
+}
+
+// Normalized cross-correlation in [-1, 1]; a fixed-size dot product the compiler vectorizes
+static float correlate(const GlyphTemplate& a, const GlyphTemplate& b) {
+    if (a.flat || b.flat) {
+        return a.flat && b.flat ? 1.0f : 0.0f;
+    }
+    float sum = 0.0f;
+    for (size_t i = 0; i < a.pixels.size(); ++i) {
+        sum += a.pixels[i] * b.pixels[i];
+    }
+    return sum;
+}
+
+bool GlyphRecognizer::learn(const cv::Mat& binary, const std::string& label) {
+    std::string characters;
+    for (char c : label) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            characters += c;
+        }
+    }
+    if (characters.empty() || binary.empty()) {
+        return false;
+    }
+
+    cv::Mat mask = inkMask(binary);
+    int lineTop = 0, lineBottom = 0;
+    std::vector<GlyphBox> boxes = segmentGlyphs(mask, lineTop, lineBottom);
+    if (boxes.size() != characters.size()) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(templateMutex);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        GlyphTemplate glyph = normalizeGlyph(mask, boxes[i], lineTop, lineBottom);
+        glyph.character = characters[i];
+
+        size_t known = 0;
+        bool duplicate = false;
+        for (const auto& existing : templates) {
+            if (existing.character == glyph.character) {
+                ++known;
+                duplicate = duplicate || correlate(existing, glyph) > 0.98f;
+            }
+        }
+        if (!duplicate && known < kMaxTemplatesPerGlyph) {
+            templates.push_back(glyph);
+        }
+    }
+    return true;
+}
+
+GlyphReadout GlyphRecognizer::recognize(const cv::Mat& binary) const {
+    GlyphReadout readout;
+    if (binary.empty()) {
+        return readout;
+    }
+    cv::Mat mask = inkMask(binary);
+    int lineTop = 0, lineBottom = 0;
+    std::vector<GlyphBox> boxes = segmentGlyphs(mask, lineTop, lineBottom);
+
+    std::shared_lock<std::shared_mutex> lock(templateMutex);
+    if (boxes.empty() || templates.empty()) {
+        return readout;
+    }
+
+    float widthSum = 0.0f;
+    for (const auto& box : boxes) {
+        widthSum += static_cast<float>(box.right - box.left);
+    }
+    float meanWidth = widthSum / boxes.size();
+
+    readout.confidence = 1.0f;
+    readout.margin = 1.0f;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        GlyphTemplate glyph = normalizeGlyph(mask, boxes[i], lineTop, lineBottom);
+        float best = -1.0f;
+        float runnerUp = -1.0f; // best score of any other character
+        char bestCharacter = '?';
+        for (const auto& candidate : templates) {
+            float ratio = glyph.aspect > candidate.aspect ? glyph.aspect / std::max(candidate.aspect, 1e-3f)
+                                                          : candidate.aspect / std::max(glyph.aspect, 1e-3f);
+            if (ratio > kMaxAspectRatio) {
+                continue;
+            }
+            float score = correlate(glyph, candidate);
+            if (score > best) {
+                if (candidate.character != bestCharacter) {
+                    runnerUp = best;
+                }
+                best = score;
+                bestCharacter = candidate.character;
+            } else if (score > runnerUp && candidate.character != bestCharacter) {
+                runnerUp = score;
+            }
+        }
+
+        // A gap wider than a typical glyph separates two numbers
+        if (i > 0 && boxes[i].left - boxes[i - 1].right > meanWidth) {
+            readout.text += ' ';
+        }
+        float confidence = std::max(best, 0.0f);
+        float margin = confidence - std::max(runnerUp, 0.0f);
+        readout.text += bestCharacter;
+        readout.glyphs.push_back({ bestCharacter, confidence, margin, boxes[i].left, boxes[i].right - boxes[i].left });
+        readout.confidence = std::min(readout.confidence, confidence);
+        readout.margin = std::min(readout.margin, margin);
+    }
+    return readout;
+}
+
+bool GlyphRecognizer::isConfident(const GlyphReadout& readout) {
+    return !readout.text.empty() && readout.confidence >= kMinGlyphConfidence && readout.margin >= kMinGlyphMargin;
+}
+
+bool GlyphRecognizer::dueForCrossCheck() {
+    size_t reads = confidentReads.fetch_add(1, std::memory_order_relaxed) + 1;
+    return reads % (knowsAllDigits() ? kGlyphCheckInterval : kGlyphCheckWhileLearning) == 0;
+}
+
+bool GlyphRecognizer::knowsAllDigits() const {
+    std::shared_lock<std::shared_mutex> lock(templateMutex);
+    bool known[10] = {};
+    for (const auto& glyph : templates) {
+        if (glyph.character >= '0' && glyph.character <= '9') {
+            known[glyph.character - '0'] = true;
+        }
+    }
+    return std::all_of(std::begin(known), std::end(known), [](bool k) { return k; });
+}
+
+bool GlyphRecognizer::isTrained() const {
+    std::shared_lock<std::shared_mutex> lock(templateMutex);
+    return !templates.empty();
+}
+
+size_t GlyphRecognizer::templateCount() const {
+    std::shared_lock<std::shared_mutex> lock(templateMutex);
+    return templates.size();
+}
+
+void GlyphRecognizer::clear() {
+    std::unique_lock<std::shared_mutex> lock(templateMutex);
+    templates.clear();
+    confidentReads.store(0);
+}
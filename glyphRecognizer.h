@@ -0,0 +1,76 @@
+#ifndef GLYPHRECOGNIZER_H
+#define GLYPHRECOGNIZER_H
+
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+static const int kGlyphWidth = 12;
+static const int kGlyphHeight = 16;
+static const size_t kMaxTemplatesPerGlyph = 8;
+static const float kMinGlyphConfidence = 0.80f; // below this the frame goes to Tesseract
+static const float kMinGlyphMargin = 0.10f;     // nor may any glyph score within this of another character
+static const int kGlyphLearnConfidence = 90;    // Tesseract reads at least this sure (mean, 0-100) become templates
+static const size_t kGlyphCheckWhileLearning = 2; // every Nth confident read is checked by Tesseract until all digits are known
+static const size_t kGlyphCheckInterval = 50;     // and every Nth after that
+
+using GlyphPixels = std::array<float, kGlyphWidth * kGlyphHeight>;
+
+// One learned sample of a character, normalized to zero mean and unit norm so
+// that correlation is a plain dot product
+struct GlyphTemplate {
+    char character;
+    GlyphPixels pixels;
+    float aspect; // width / line height of the original glyph
+    bool flat;    // solid box (e.g. '-' or '.'), where the pixels carry no shape
+};
+
+struct RecognizedGlyph {
+    char character;
+    float confidence;
+    float margin; // over the best-scoring different character
+    int x;
+    int width;
+};
+
+struct GlyphReadout {
+    std::string text;
+    float confidence = 0.0f; // of the least certain glyph
+    float margin = 0.0f;     // of the most contested glyph
+    std::vector<RecognizedGlyph> glyphs;
+};
+
+// Reads fixed-font HUD numbers by template correlation. The thresholded ROI
+// is split into connected components; each is cropped to the full line
+// height (so '-', '.' and ',' keep their vertical position), scaled to
+// kGlyphWidth x kGlyphHeight and compared against every learned template.
+class GlyphRecognizer {
+    mutable std::shared_mutex templateMutex;
+    std::vector<GlyphTemplate> templates;
+    std::atomic<size_t> confidentReads{ 0 };
+
+public:
+    // Learns one template per glyph when the frame splits into exactly as many
+    // components as label has non-space characters
+    bool learn(const cv::Mat& binary, const std::string& label);
+    GlyphReadout recognize(const cv::Mat& binary) const;
+
+    // Sure enough to skip Tesseract: every glyph above kMinGlyphConfidence and
+    // kMinGlyphMargin clear of its runner-up character
+    static bool isConfident(const GlyphReadout& readout);
+
+    // Counts confident reads and says when one should be checked against
+    // Tesseract anyway. A digit that was never learned can still score high
+    // against a similar one, so checks are frequent until all ten are known.
+    bool dueForCrossCheck();
+    bool knowsAllDigits() const;
+
+    bool isTrained() const;
+    size_t templateCount() const;
+    void clear();
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "imagePreprocess.h"
+//=====================//
+#include <algorithm>
+#include <cstring>
+#include <opencv2/imgproc.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static const int kMaxUpscale = 4;
+
+// Fixed-point BT.601 luma, the weights OpenCV's BGR2GRAY uses (sum 256)
+static const int kWeightB = 29;
+static const int kWeightG = 150;
+static const int kWeightR = 77;
+
+static inline uint8_t grayOf(const uint8_t* px) {
+    return static_cast<uint8_t>((px[0] * kWeightB + px[1] * kWeightG + px[2] * kWeightR + 128) >> 8);
+}
+
+#if defined(__SSE2__)
+// Four BGRA pixels -> four 32-bit gray values
+static inline __m128i grayOf4(__m128i bgra, __m128i weights, __m128i zero) {
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(bgra, zero), weights); // B0G0 R0A0 B1G1 R1A1
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(bgra, zero), weights); // B2G2 R2A2 B3G3 R3A3
+    __m128i bg = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i ra = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bg, ra), _mm_set1_epi32(128)), 8);
+}
+#endif
+
+void grayAndHistogramRow(const uint8_t* src, int channels, size_t pixels, uint8_t* gray, uint32_t* hist) {
+    size_t i = 0;
+    if (channels == 1) {
+        if (gray != src) {
+            std::memcpy(gray, src, pixels);
+        }
+        for (; i < pixels; ++i) {
+            ++hist[gray[i]];
+        }
+        return;
+    }
+
+#if defined(__SSE2__)
+    if (channels == 4) {
+        const __m128i weights = _mm_set_epi16(0, kWeightR, kWeightG, kWeightB, 0, kWeightR, kWeightG, kWeightB);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= pixels; i += 16) {
+            const __m128i* in = reinterpret_cast<const __m128i*>(src + i * 4);
+            __m128i g0 = grayOf4(_mm_loadu_si128(in), weights, zero);
+            __m128i g1 = grayOf4(_mm_loadu_si128(in + 1), weights, zero);
+            __m128i g2 = grayOf4(_mm_loadu_si128(in + 2), weights, zero);
+            __m128i g3 = grayOf4(_mm_loadu_si128(in + 3), weights, zero);
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(g0, g1), _mm_packs_epi32(g2, g3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gray + i), packed);
+            // The histogram is a scatter; it reads the bytes just written while they are in L1
+            for (size_t k = 0; k < 16; ++k) {
+                ++hist[gray[i + k]];
+            }
+        }
+    }
+#endif
+    for (; i < pixels; ++i) {
+        uint8_t value = grayOf(src + i * channels);
+        gray[i] = value;
+        ++hist[value];
+    }
+}
+
+int otsuThreshold(const uint32_t* hist, size_t total) {
+    double sum = 0.0;
+    for (int t = 0; t < 256; ++t) {
+        sum += static_cast<double>(t) * hist[t];
+    }
+
+    double sumBackground = 0.0;
+    size_t weightBackground = 0;
+    double bestVariance = -1.0;
+    int threshold = 0;
+    for (int t = 0; t < 256; ++t) {
+        weightBackground += hist[t];
+        if (weightBackground == 0) {
+            continue;
+        }
+        size_t weightForeground = total - weightBackground;
+        if (weightForeground == 0) {
+            break;
+        }
+        sumBackground += static_cast<double>(t) * hist[t];
+        double meanBackground = sumBackground / weightBackground;
+        double meanForeground = (sum - sumBackground) / weightForeground;
+        double difference = meanBackground - meanForeground;
+        double variance = static_cast<double>(weightBackground) * weightForeground * difference * difference;
+        if (variance > bestVariance) {
+            bestVariance = variance;
+            threshold = t;
+        }
+    }
+    return threshold;
+}
+
+void thresholdInPlace(uint8_t* data, size_t length, int threshold) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Unsigned compare via the signed one: flip the top bit of both sides
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i limit = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(threshold)), bias);
+    for (; i + 16 <= length; i += 16) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        __m128i v = _mm_xor_si128(_mm_loadu_si128(p), bias);
+        _mm_storeu_si128(p, _mm_cmpgt_epi8(v, limit));
+    }
+#endif
+    for (; i < length; ++i) {
+        data[i] = data[i] > threshold ? 255 : 0;
+    }
+}
+
+cv::Mat inkMask(const cv::Mat& binary) {
+    cv::Mat mask;
+    if (cv::countNonZero(binary) > static_cast<int>(binary.total() / 2)) {
+        cv::bitwise_not(binary, mask);
+    } else {
+        mask = binary;
+    }
+    return mask;
+}
+
+cv::Mat MatRing::acquire(int rows, int cols, int type) {
+    for (auto& mat : mats) {
+        // Only our own reference left: nobody downstream still reads it
+        if (mat.u && CV_XADD(&mat.u->refcount, 0) == 1) {
+            mat.create(rows, cols, type);
+            return mat;
+        }
+    }
+    if (mats.size() < maxMats) {
+        mats.emplace_back(rows, cols, type);
+        return mats.back();
+    }
+    return cv::Mat(rows, cols, type); // every buffer still in flight
+}
+
+void OcrPreprocessor::buildGray(const cv::Mat& frame, cv::Mat& dst) {
+    std::fill(std::begin(hist), std::end(hist), 0u);
+    int channels = frame.channels();
+    for (int y = 0; y < frame.rows; ++y) {
+        grayAndHistogramRow(frame.ptr<uint8_t>(y), channels, static_cast<size_t>(frame.cols), dst.ptr<uint8_t>(y), hist);
+    }
+    lastThreshold = otsuThreshold(hist, frame.total());
+}
+
+cv::Mat OcrPreprocessor::process(const cv::Mat& frame) {
+    int scale = 1;
+    if (minOcrHeight > 0 && frame.rows > 0 && frame.rows < minOcrHeight) {
+        scale = std::min(kMaxUpscale, (minOcrHeight + frame.rows - 1) / frame.rows);
+    }
+
+    cv::Mat binary = outputs.acquire(frame.rows * scale, frame.cols * scale, CV_8UC1);
+    if (scale == 1) {
+        buildGray(frame, binary);
+    } else {
+        // The threshold comes from the original pixels; interpolation only adds in-between shades
+        gray.create(frame.rows, frame.cols, CV_8UC1);
+        buildGray(frame, gray);
+        cv::resize(gray, binary, binary.size(), 0, 0, cv::INTER_LINEAR);
+    }
+    thresholdInPlace(binary.data, binary.total(), lastThreshold); // acquire() hands out continuous images
+    return binary;
+}
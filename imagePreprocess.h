@@ -0,0 +1,51 @@
+#ifndef IMAGEPREPROCESS_H
+#define IMAGEPREPROCESS_H
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+#include <opencv2/core.hpp>
+
+// Raw kernels, exposed for the microbenchmark. `channels` is 4 (BGRA), 3 (BGR) or 1.
+// Converts one row to gray and adds its pixels to hist[256] in the same pass.
+void grayAndHistogramRow(const uint8_t* src, int channels, size_t pixels, uint8_t* gray, uint32_t* hist);
+int otsuThreshold(const uint32_t* hist, size_t total);
+void thresholdInPlace(uint8_t* data, size_t length, int threshold); // > threshold -> 255, else 0
+
+// Ink as 255 on 0: the thresholded image may have light text on dark or the
+// reverse, and text is the minority colour either way
+cv::Mat inkMask(const cv::Mat& binary);
+
+// A few images handed downstream and recycled once nobody else holds them,
+// so steady-state frames do not allocate
+class MatRing {
+    std::vector<cv::Mat> mats;
+    size_t maxMats;
+
+public:
+    explicit MatRing(size_t capacity = 4) : maxMats(capacity) { mats.reserve(capacity); }
+    cv::Mat acquire(int rows, int cols, int type);
+};
+
+// Grayscale + Otsu binarization ahead of OCR, in one fused pass over the
+// frame plus an in-place threshold. Accepts BGRA (screen), BGR (files) or
+// gray frames, including non-continuous ROI crops. Frames shorter than
+// minOcrHeight are scaled up by an integer factor (at most 4x) first.
+class OcrPreprocessor {
+    cv::Mat gray;      // reused when scaling up
+    MatRing outputs;
+    int minOcrHeight;
+    uint32_t hist[256];
+    int lastThreshold = 0;
+
+    void buildGray(const cv::Mat& frame, cv::Mat& dst);
+
+public:
+    explicit OcrPreprocessor(int minHeight = 0) : minOcrHeight(minHeight) {}
+
+    // The binary image stays valid until the caller drops it
+    cv::Mat process(const cv::Mat& frame);
+    int threshold() const { return lastThreshold; }
+};
+
+#endif
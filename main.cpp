@@ -3,15 +3,21 @@
 #include "processSearcher.h"
 #include "consoleHandler.h"
 #include "errorHandler.h"
+#include "candidateSet.h"
+#include "valueSearch.h"
+#include "frameSource.h"
 //=====================//
 #include <windows.h>
 #include <winuser.h> 
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <mutex>
 #include <chrono>
 #include <vector>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <opencv2/opencv.hpp>
 #include <tesseract/baseapi.h>
 #include <leptonica/allheaders.h>
@@ -248,6 +254,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
                         DeleteObject(hBorderPen);
                     }
             
+                    // Outline watched regions in green
+                    HPEN hWatchPen = CreatePen(PS_SOLID, 2, RGB(0, 255, 0));
+                    HPEN hOldWatchPen = (HPEN)SelectObject(memDC, hWatchPen);
+                    for (const auto& region : shareInfo.getWatchedRegions()) {
+                        MoveToEx(memDC, region.rect.left, region.rect.top, NULL);
+                        LineTo(memDC, region.rect.right, region.rect.top);
+                        LineTo(memDC, region.rect.right, region.rect.bottom);
+                        LineTo(memDC, region.rect.left, region.rect.bottom);
+                        LineTo(memDC, region.rect.left, region.rect.top);
+                    }
+                    SelectObject(memDC, hOldWatchPen);
+                    DeleteObject(hWatchPen);
+
                     // Draw drag rectangle if active
                     if (isDragging) {
                         HBRUSH hDragBrush = CreateSolidBrush(RGB(100, 100, 255));  // Blue tint for visibility
@@ -410,10 +429,23 @@ void PerformMemoryWrite() {
     int writeSuccessCount = 0;
     int writeFailCount = 0;
 
+    // Encoded candidates get the value written back in the encoding they were found with
+    std::vector<EncodedHit> encodedHits;
+    if (shareInfo.getScanValueType() == ScanValueType::Encoded) {
+        encodedHits = shareInfo.getEncodedCandidates();
+    }
+
     for (uintptr_t addr : addresses) {
+        int storedValue = newValue;
+        for (const auto& hit : encodedHits) {
+            if (hit.address == addr) {
+                storedValue = encodeValue(hit.encoding, newValue);
+                break;
+            }
+        }
         SIZE_T bytesWritten = 0;
-        BOOL success = WriteProcessMemory(hProcess, (LPVOID)addr, &newValue, sizeof(newValue), &bytesWritten);
-        if (success && bytesWritten == sizeof(newValue)) {
+        BOOL success = WriteProcessMemory(hProcess, (LPVOID)addr, &storedValue, sizeof(storedValue), &bytesWritten);
+        if (success && bytesWritten == sizeof(storedValue)) {
             // ... success logging ...
             writeSuccessCount++;
         } else {
@@ -578,6 +610,159 @@ void CreateIntValueWindow() {
     }
 }
 
+// Snapshots belong to one target; a new pid starts the history over
+static std::mutex snapshotMutex;
+static SnapshotStore snapshots;
+static DWORD snapshotPid = 0;
+static std::atomic<bool> snapshotInProgress = false;
+
+// Captures a deduplicated memory snapshot and, once there are two, keeps only
+// the int32 candidates that changed between them (every changed int32 if no
+// search has run yet, held under the candidate budget).
+// Encoded refines read the encoded hits, so they have to shrink to the same (sorted) addresses
+static void narrowEncodedCandidates(const std::vector<uintptr_t>& kept) {
+    if (shareInfo.getScanValueType() != ScanValueType::Encoded) {
+        return;
+    }
+    std::vector<EncodedHit> hits = shareInfo.getEncodedCandidates();
+    hits.erase(std::remove_if(hits.begin(), hits.end(), [&](const EncodedHit& hit) {
+        return !std::binary_search(kept.begin(), kept.end(), hit.address);
+    }), hits.end());
+    shareInfo.updateEncodedCandidates(hits);
+}
+
+static void TakeSnapshotAndNarrow() {
+    DWORD pid = shareInfo.getThePIDOfProsses();
+    if (pid == 0) {
+        LOG_WARNING("Snapshot requested before a target process was found.");
+        snapshotInProgress.store(false);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (pid != snapshotPid) {
+        snapshots.clear();
+        snapshotPid = pid;
+    }
+    if (!captureSnapshot(pid, snapshots)) {
+        snapshotInProgress.store(false);
+        return;
+    }
+
+    const SnapshotGeneration* older = snapshots.previous();
+    const SnapshotGeneration* newer = snapshots.latest();
+    if (older && newer) {
+        std::vector<uintptr_t> current = shareInfo.getVoidPoitersFinaly();
+        if (!current.empty()) {
+            normalizeCandidates(current);
+            std::vector<uintptr_t> changed = intersectCandidates(current, findChangedValues(snapshots, *older, *newer, ValueChange::Changed));
+            narrowEncodedCandidates(changed);
+            shareInfo.updateVoidPoitersFinaly(changed);
+            LOG_INFO("Values changed since the previous snapshot: " + std::to_string(changed.size()) + " candidates.");
+            snapshotInProgress.store(false);
+            return;
+        }
+
+        // Every changed int32 (or every spilled candidate that changed) can be far more than
+        // the candidate budget, so the result goes through a CandidateStore like a scan's hits
+        CandidateStore changed(shareInfo.candidateBudgetBytes.load());
+        if (shareInfo.spilledCandidateCount() > 0) {
+            CandidateStore stored = shareInfo.takeSpilledCandidates();
+            stored.forEachSorted([&](const uintptr_t* addresses, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    int32_t before = 0, after = 0;
+                    if (snapshots.readValue(*older, addresses[i], &before, sizeof(before)) &&
+                        snapshots.readValue(*newer, addresses[i], &after, sizeof(after)) && before != after) {
+                        changed.push(addresses[i]);
+                    }
+                }
+            });
+        } else {
+            forEachChangedValue(snapshots, *older, *newer, [&](uintptr_t address, int32_t, int32_t) {
+                changed.push(address);
+            });
+        }
+        LOG_INFO("Values changed since the previous snapshot: " + std::to_string(changed.size()) + " candidates.");
+
+        if (changed.spilled()) {
+            shareInfo.updateVoidPoitersFinaly({});
+            shareInfo.updateSpilledCandidates(std::move(changed));
+        } else {
+            std::vector<uintptr_t> narrowed = changed.toVector();
+            narrowEncodedCandidates(narrowed);
+            shareInfo.updateVoidPoitersFinaly(narrowed);
+            shareInfo.updateSpilledCandidates(CandidateStore());
+        }
+    }
+    snapshotInProgress.store(false);
+}
+
+// Set operations work on the in-memory list; candidates spilled to disk have to be refined down first
+static bool candidatesInMemory(const char* operation) {
+    size_t spilled = shareInfo.spilledCandidateCount();
+    if (spilled > 0) {
+        LOG_WARNING(std::string("Cannot ") + operation + ": " + std::to_string(spilled) +
+                    " candidates are held on disk past the memory budget. Refine further first.");
+        return false;
+    }
+    return true;
+}
+
+static void MarkCandidates() {
+    if (!candidatesInMemory("mark candidates")) {
+        return;
+    }
+    std::vector<uintptr_t> current = shareInfo.getVoidPoitersFinaly();
+    normalizeCandidates(current);
+    shareInfo.updateMarkedCandidates(current);
+    LOG_INFO("Marked " + std::to_string(current.size()) + " candidates for set operations.");
+}
+
+static void CombineWithMarked(bool intersect) {
+    if (!candidatesInMemory(intersect ? "intersect with the marked set" : "subtract the marked set")) {
+        return;
+    }
+    std::vector<uintptr_t> current = shareInfo.getVoidPoitersFinaly();
+    normalizeCandidates(current);
+    std::vector<uintptr_t> marked = shareInfo.getMarkedCandidates();
+    std::vector<uintptr_t> combined = intersect ? intersectCandidates(current, marked)
+                                                : subtractCandidates(current, marked);
+    narrowEncodedCandidates(combined);
+    shareInfo.updateVoidPoitersFinaly(combined);
+    LOG_INFO(std::string(intersect ? "Intersected" : "Subtracted") + " marked set: " +
+             std::to_string(current.size()) + " -> " + std::to_string(combined.size()) + " candidates.");
+}
+
+// Keeps reading the current selection under its own name, so the next drag
+// can pick another number to track alongside it
+static int nextRegionNumber = 2; // the main selection is region 1
+
+static void WatchSelectedRegion() {
+    RECT rect = shareInfo.getSelected();
+    if (rect.left < 0 || rect.top < 0 || rect.right <= rect.left || rect.bottom <= rect.top) {
+        LOG_WARNING("Select an area before watching it.");
+        return;
+    }
+    std::vector<WatchedRegion> watched = shareInfo.getWatchedRegions();
+    std::string name = "region " + std::to_string(nextRegionNumber++);
+    watched.push_back({ name, rect });
+    shareInfo.updateWatchedRegions(watched);
+    InvalidateRect(g_hWnd, NULL, TRUE);
+    LOG_INFO("Watching '" + name + "'; " + std::to_string(watched.size()) + " region(s) besides the selection.");
+}
+
+static void UnwatchLastRegion() {
+    std::vector<WatchedRegion> watched = shareInfo.getWatchedRegions();
+    if (watched.empty()) {
+        LOG_INFO("No watched regions to remove.");
+        return;
+    }
+    LOG_INFO("Stopped watching '" + watched.back().name + "'.");
+    watched.pop_back();
+    shareInfo.updateWatchedRegions(watched);
+    InvalidateRect(g_hWnd, NULL, TRUE);
+}
+
 // Function to toggle the overlay visibility
 static void ToggleOverlay() {
     if (isOverlayVisible) {
@@ -605,12 +790,164 @@ static void ToggleOverlay() {
     }
     shareInfo.update(isOverlayVisible.load(), isRunning.load(), brightRect, isDragging, g_hWnd);
 }
+// Splits on spaces; double quotes group a path with spaces and are dropped
+static std::vector<std::string> splitCommandLine(const std::string& commandLine) {
+    std::vector<std::string> args;
+    std::string current;
+    bool quoted = false;
+    bool pending = false;
+    for (char c : commandLine) {
+        if (c == '"') {
+            quoted = !quoted;
+            pending = true;
+        } else if (c == ' ' && !quoted) {
+            if (pending) {
+                args.push_back(current);
+            }
+            current.clear();
+            pending = false;
+        } else {
+            current += c;
+            pending = true;
+        }
+    }
+    if (pending) {
+        args.push_back(current);
+    }
+    return args;
+}
+
+static bool parseFractionOption(const std::string& option, const std::string& text, float& out) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || !(value >= 0.0 && value <= 1.0)) {
+        LOG_WARNING("Ignoring " + option + " " + text + ": expected a number from 0 to 1.");
+        return false;
+    }
+    out = static_cast<float>(value);
+    return true;
+}
+
+// Whole numbers only: "2.5" readings of a vote window would otherwise be truncated unnoticed
+static bool parseIntegerOption(const std::string& option, const std::string& text, long low, long high, long& out) {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < low || value > high) {
+        LOG_WARNING("Ignoring " + option + " " + text + ": expected a whole number from " + std::to_string(low) + " to " +
+                    std::to_string(high) + ".");
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+// A single character that cannot be part of a digit run; "none" is 0 where allowed
+static bool parseSeparatorOption(const std::string& option, const std::string& text, bool allowNone, char& out) {
+    if (allowNone && text == "none") {
+        out = 0;
+        return true;
+    }
+    if (text.size() != 1 || std::isdigit(static_cast<unsigned char>(text[0])) || text[0] == '-') {
+        LOG_WARNING("Ignoring " + option + " " + text + ": expected a single non-digit character" + (allowNone ? " or none." : "."));
+        return false;
+    }
+    out = text[0];
+    return true;
+}
+
+// Applies the command line to shareInfo and returns the replay path, if any:
+//   --replay <png directory|video file>  feed a recorded session through the OCR path instead of the screen
+//   --min-confidence <0-1>               least certain character a reading may have and still vote
+//   --vote-window <n>                    recent readings that vote on a region's value
+//   --vote-quorum <n>                    matching votes a new value needs
+//   --decimal-point <c>                  how the game writes 12.5 (default '.')
+//   --group-separator <c|none>           how it writes 1,234 (default ',')
+//   --no-suffixes                        k/m/b after a number are not multipliers
+//   --min-ocr-height <px>                scale shorter text boxes up before OCR (0 turns it off)
+static std::string applyCommandLine(const std::string& commandLine) {
+    static const char* const kValueOptions[] = { "--replay", "--min-confidence", "--vote-window", "--vote-quorum",
+                                                 "--decimal-point", "--group-separator", "--min-ocr-height" };
+    std::vector<std::string> args = splitCommandLine(commandLine);
+    std::string replayPath;
+    ReadingVoteConfig voting = shareInfo.getReadingVoteConfig();
+    NumberLocale locale = shareInfo.getNumberLocale();
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg == "--no-suffixes") {
+            locale.suffixes = false;
+            continue;
+        }
+        if (std::find(std::begin(kValueOptions), std::end(kValueOptions), arg) == std::end(kValueOptions)) {
+            LOG_WARNING("Ignoring unknown command-line option: " + arg);
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            LOG_WARNING("Ignoring " + arg + ": it needs a value.");
+            break;
+        }
+        const std::string& value = args[++i];
+        long count;
+        char separator;
+        if (arg == "--replay") {
+            replayPath = value;
+        } else if (arg == "--min-confidence") {
+            parseFractionOption(arg, value, voting.minConfidence);
+        } else if (arg == "--vote-window") {
+            if (parseIntegerOption(arg, value, 1, 32, count)) {
+                voting.window = static_cast<size_t>(count);
+            }
+        } else if (arg == "--vote-quorum") {
+            if (parseIntegerOption(arg, value, 1, 32, count)) {
+                voting.quorum = static_cast<size_t>(count);
+            }
+        } else if (arg == "--min-ocr-height") {
+            if (parseIntegerOption(arg, value, 0, 256, count)) {
+                shareInfo.minOcrHeight.store(static_cast<int>(count));
+            }
+        } else if (arg == "--decimal-point") {
+            if (parseSeparatorOption(arg, value, false, separator)) {
+                locale.decimalPoint = separator;
+            }
+        } else if (arg == "--group-separator") {
+            if (parseSeparatorOption(arg, value, true, separator)) {
+                locale.groupSeparator = separator;
+            }
+        }
+    }
+    if (voting.quorum > voting.window) {
+        LOG_WARNING("Vote quorum " + std::to_string(voting.quorum) + " exceeds the window; using " + std::to_string(voting.window) + ".");
+        voting.quorum = voting.window;
+    }
+    shareInfo.updateReadingVoteConfig(voting);
+
+    if (locale.groupSeparator == locale.decimalPoint) {
+        LOG_WARNING(std::string("Group separator '") + locale.groupSeparator + "' is also the decimal point; turning grouping off.");
+        locale.groupSeparator = 0;
+    }
+    shareInfo.updateNumberLocale(locale);
+    return replayPath;
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
     g_hInstance = hInstance;
     REGISTER_HANDLE(g_hInstance);
 
+    // Before the screen reader starts, so its pipeline sees the voting settings
+    std::string replayPath = applyCommandLine(lpCmdLine ? lpCmdLine : "");
+
     // Start threads
-    std::thread screenReaderThread([]() { screenReaderLoop(true); });
+    std::thread screenReaderThread([replayPath]() {
+        if (replayPath.empty()) {
+            screenReaderLoop(true);
+            return;
+        }
+        std::unique_ptr<FrameSource> source = openRecordedFrames(replayPath);
+        if (!source) {
+            LOG_ERROR("No frames found at replay path: " + replayPath);
+            return;
+        }
+        replayFrameSource(*source, true);
+    });
     std::thread processSearcherThread([]() { SearchForProcessLoop(true); });
 
     // Register window class
@@ -677,6 +1014,48 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 shareInfo.writeValueInputReady.store(false);
                 CreateInputWindow();
                 Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x46)) { // Ctrl+Alt+F
+                ScanValueType next = ScanValueType::Int32;
+                switch (shareInfo.getScanValueType()) {
+                    case ScanValueType::Int32: next = ScanValueType::Float; break;
+                    case ScanValueType::Float: next = ScanValueType::Double; break;
+                    case ScanValueType::Double: next = ScanValueType::Encoded; break;
+                    case ScanValueType::Encoded: next = ScanValueType::Int32; break;
+                }
+                shareInfo.updateScanValueType(next);
+                shareInfo.updateVoidPoitersFinaly({});
+                shareInfo.updateLastSearchedValue(INT_MIN);
+                shareInfo.updateLastSearchedDisplay("");
+                shareInfo.updateEncodedCandidates({});
+                shareInfo.updateSpilledCandidates(CandidateStore());
+                shareInfo.updateSecondaryValues({});
+                const char* typeNames[] = { "int", "float", "double", "encoded int" };
+                LOG_INFO(std::string("Scan value type switched to ") + typeNames[static_cast<int>(next)] + ".");
+                Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x4D)) { // Ctrl+Alt+M
+                MarkCandidates();
+                Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && (isKeyPressed(0x49) || isKeyPressed(0x44))) { // Ctrl+Alt+I / Ctrl+Alt+D
+                CombineWithMarked(isKeyPressed(0x49));
+                Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x43)) { // Ctrl+Alt+C
+                bool enabled = !shareInfo.correlationRefine.load();
+                shareInfo.correlationRefine.store(enabled);
+                LOG_INFO(std::string("Sequence-correlation refine ") + (enabled ? "enabled." : "disabled."));
+                Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x4E)) { // Ctrl+Alt+N
+                if (!snapshotInProgress.exchange(true)) {
+                    std::thread(TakeSnapshotAndNarrow).detach();
+                } else {
+                    LOG_INFO("A snapshot is already being taken.");
+                }
+                Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x57)) { // Ctrl+Alt+W
+                WatchSelectedRegion();
+                Sleep(300); // Debounce
+            } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x55)) { // Ctrl+Alt+U
+                UnwatchLastRegion();
+                Sleep(300); // Debounce
             } else if (isKeyPressed(VK_CONTROL) && isKeyPressed(VK_MENU) && isKeyPressed(0x53)) { // Ctrl+Alt+S
                 LOG_FATAL("Exit requested via hotkey (Ctrl+Alt+S)."); // Use INFO or FATAL consistently
                 isRunning.store(false);
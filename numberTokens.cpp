@@ -0,0 +1,153 @@
+#include "numberTokens.h"
+//=====================//
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+static const uint64_t kMantissaLimit = (UINT64_MAX - 9) / 10;
+static const uint64_t kPowersOfTen[] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+                                         100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+                                         10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+                                         100000000000000000ull, 1000000000000000000ull };
+static const int kMaxExactDecimals = sizeof(kPowersOfTen) / sizeof(kPowersOfTen[0]) - 1;
+
+static inline bool isDigit(unsigned char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+static inline bool isLetter(unsigned char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+}
+
+static uint32_t suffixScale(unsigned char c) {
+    switch (c) {
+        case 'k': case 'K': return 1000u;
+        case 'm': case 'M': return 1000000u;
+        case 'b': case 'B': return 1000000000u;
+        default:            return 1u;
+    }
+}
+
+// Any byte of the word in '0'..'9' (bytes above 127 never match); the
+// "has value between" bit trick, so non-digit text is skipped 8 bytes at a time
+static inline bool wordHasDigit(uint64_t word) {
+    const uint64_t ones = ~0ull / 255;
+    const uint64_t low7 = word & (ones * 127);
+    return ((ones * (127 + '9' + 1) - low7) & ~word & (low7 + ones * (127 - ('0' - 1))) & (ones * 128)) != 0;
+}
+
+// Appends the digit run at text[pos] to the mantissa; returns its length
+static size_t takeDigits(const unsigned char* text, size_t length, size_t& pos, NumberToken& token) {
+    size_t start = pos;
+    for (; pos < length && isDigit(text[pos]); ++pos) {
+        if (token.mantissa > kMantissaLimit) {
+            token.overflow = true;
+        } else {
+            token.mantissa = token.mantissa * 10 + (text[pos] - '0');
+        }
+    }
+    return pos - start;
+}
+
+// Exactly groupSize digits after the separator at `pos`, and no more
+static bool isGroupAt(const unsigned char* text, size_t length, size_t pos, size_t groupSize) {
+    if (pos + groupSize >= length) {
+        return false;
+    }
+    for (size_t i = 1; i <= groupSize; ++i) {
+        if (!isDigit(text[pos + i])) {
+            return false;
+        }
+    }
+    return pos + groupSize + 1 == length || !isDigit(text[pos + groupSize + 1]);
+}
+
+size_t tokenizeNumbers(std::string_view text, std::vector<NumberToken>& out, const NumberLocale& locale) {
+    out.clear();
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t n = text.size();
+    const unsigned char point = static_cast<unsigned char>(locale.decimalPoint);
+    const unsigned char separator = static_cast<unsigned char>(locale.groupSeparator);
+
+    size_t pos = 0;
+    while (pos < n) {
+        if (!isDigit(s[pos])) {
+            ++pos;
+            uint64_t word;
+            while (pos + sizeof(word) <= n) {
+                std::memcpy(&word, s + pos, sizeof(word));
+                if (wordHasDigit(word)) {
+                    break;
+                }
+                pos += sizeof(word);
+            }
+            continue;
+        }
+
+        NumberToken token;
+        token.offset = pos;
+        if (pos > 0 && s[pos - 1] == '-' && (pos < 2 || !(isDigit(s[pos - 2]) || isLetter(s[pos - 2])))) {
+            token.negative = true;
+            token.offset = pos - 1;
+        }
+
+        size_t leading = takeDigits(s, n, pos, token);
+        if (separator && leading <= locale.groupSize) {
+            while (pos < n && s[pos] == separator && isGroupAt(s, n, pos, locale.groupSize)) {
+                ++pos;
+                takeDigits(s, n, pos, token);
+                token.grouped = true;
+            }
+        }
+        if (pos + 1 < n && s[pos] == point && isDigit(s[pos + 1])) {
+            ++pos;
+            token.decimals = static_cast<int>(takeDigits(s, n, pos, token));
+            token.type = NumberType::Decimal;
+        }
+        if (locale.suffixes && pos < n && suffixScale(s[pos]) != 1u && (pos + 1 == n || !isLetter(s[pos + 1]))) {
+            token.scale = suffixScale(s[pos]);
+            token.type = NumberType::Scaled;
+            ++pos;
+        }
+
+        token.length = pos - token.offset;
+        out.push_back(token);
+    }
+    return out.size();
+}
+
+std::vector<NumberToken> tokenizeNumbers(std::string_view text, const NumberLocale& locale) {
+    std::vector<NumberToken> tokens;
+    tokenizeNumbers(text, tokens, locale);
+    return tokens;
+}
+
+double NumberToken::value() const {
+    // One division by an exact power of ten rounds once
+    double magnitude = static_cast<double>(mantissa);
+    if (decimals <= kMaxExactDecimals) {
+        magnitude /= static_cast<double>(kPowersOfTen[decimals]);
+    } else {
+        magnitude /= std::pow(10.0, decimals);
+    }
+    magnitude *= scale;
+    return negative ? -magnitude : magnitude;
+}
+
+bool NumberToken::toInt(int& out) const {
+    if (overflow || decimals > kMaxExactDecimals || mantissa > UINT64_MAX / scale) {
+        return false;
+    }
+    uint64_t scaled = mantissa * scale;
+    uint64_t divisor = kPowersOfTen[decimals];
+    if (scaled % divisor != 0) {
+        return false;
+    }
+    uint64_t magnitude = scaled / divisor;
+    uint64_t limit = negative ? static_cast<uint64_t>(INT_MAX) + 1 : static_cast<uint64_t>(INT_MAX);
+    if (magnitude > limit) {
+        return false;
+    }
+    out = negative ? static_cast<int>(-static_cast<int64_t>(magnitude)) : static_cast<int>(magnitude);
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef NUMBERTOKENS_H
+#define NUMBERTOKENS_H
+
+#include <string_view>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+// How numbers are written on screen. The default is "-1,234.5k"; a game using
+// "1.234,5" swaps the two separators, and groupSeparator 0 turns grouping off.
+struct NumberLocale {
+    char decimalPoint = '.';
+    char groupSeparator = ',';
+    size_t groupSize = 3;
+    bool suffixes = true; // k/K = 1e3, m/M = 1e6, b/B = 1e9
+};
+
+enum class NumberType : uint8_t {
+    Integer, // "1234", "-5", "1,234"
+    Decimal, // "12.5"
+    Scaled   // "12k", "1.5M": a suffix multiplies the digits
+};
+
+// One number in OCR text: where it is, how it was written, and its digits
+// as an exact integer mantissa ("-1,234.5k" -> mantissa 12345, decimals 1,
+// scale 1000, negative, grouped).
+struct NumberToken {
+    size_t offset = 0; // of the first character, sign included
+    size_t length = 0; // sign, digits, separators and suffix
+    NumberType type = NumberType::Integer;
+    bool negative = false;
+    bool grouped = false;  // had group separators
+    bool overflow = false; // more digits than the mantissa holds; the value is not usable
+    int decimals = 0;
+    uint32_t scale = 1;
+    uint64_t mantissa = 0;
+
+    double value() const;
+    // The token's exact value when it is a whole number that fits an int ("12.5k" is 12500, "12.5" is not)
+    bool toInt(int& out) const;
+};
+
+// Single pass, no allocation beyond `out` growing: a '-' directly before the
+// digits is a sign unless it follows a letter or digit ("10-20" is two
+// numbers), a group separator counts only before exactly groupSize digits,
+// and the decimal point only once and before a digit. Returns out.size().
+size_t tokenizeNumbers(std::string_view text, std::vector<NumberToken>& out, const NumberLocale& locale = NumberLocale());
+std::vector<NumberToken> tokenizeNumbers(std::string_view text, const NumberLocale& locale = NumberLocale());
+
+#endif
@@ -0,0 +1,117 @@
+#include "ocrEnginePool.h"
+#ifdef _WIN32
+#include "errorHandler.h"
+#endif
+//=====================//
+#include <algorithm>
+#include <filesystem>
+#ifndef _WIN32
+#include <iostream>
+// Headless builds (the OCR benchmark) have no error handler; report on stderr
+#define LOG_INFO(msg) (std::cerr << (msg) << std::endl)
+#define LOG_FATAL(msg) (std::cerr << (msg) << std::endl)
+#endif
+#include <tesseract/resultiterator.h>
+
+namespace fs = std::filesystem;
+
+OcrEnginePool ocrEngines;
+
+OcrEngineLease::~OcrEngineLease() {
+    if (engine) {
+        pool->release(engine);
+    }
+}
+
+OcrEnginePool::~OcrEnginePool() {
+    for (auto& engine : engines) {
+        engine->End();
+    }
+}
+
+bool OcrEnginePool::init(const std::string& tessdataPath, const std::string& language, size_t count) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (initialized) {
+        return true;
+    }
+    if (!fs::exists(tessdataPath)) {
+        LOG_FATAL("Tesseract data path not found: " + tessdataPath);
+        return false;
+    }
+
+    // Dictionaries only exist to pull words towards English; they can only hurt numbers.
+    // These are init-time parameters, so they have to go through Init rather than SetVariable.
+    std::vector<std::string> initVars = { "load_system_dawg", "load_freq_dawg" };
+    std::vector<std::string> initValues = { "0", "0" };
+
+    for (size_t i = 0; i < count; ++i) {
+        auto engine = std::make_unique<tesseract::TessBaseAPI>();
+        if (engine->Init(tessdataPath.c_str(), language.c_str(), tesseract::OEM_DEFAULT, nullptr, 0, &initVars, &initValues, false)) {
+            LOG_FATAL("Tesseract initialization failed.");
+            break;
+        }
+        engine->SetPageSegMode(tesseract::PSM_SINGLE_LINE);
+        engine->SetVariable("tessedit_char_whitelist", kOcrCharWhitelist);
+        idle.push_back(engine.get());
+        engines.push_back(std::move(engine));
+    }
+
+    initialized = !engines.empty();
+    if (initialized) {
+        LOG_INFO("Initialized " + std::to_string(engines.size()) + " Tesseract engine(s) for numeric OCR.");
+    }
+    return initialized;
+}
+
+bool OcrEnginePool::isInitialized() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return initialized;
+}
+
+size_t OcrEnginePool::size() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return engines.size();
+}
+
+OcrEngineLease OcrEnginePool::acquire() {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    if (!initialized) {
+        return OcrEngineLease(this, nullptr);
+    }
+    engineReturned.wait(lock, [this] { return !idle.empty(); });
+    tesseract::TessBaseAPI* engine = idle.back();
+    idle.pop_back();
+    return OcrEngineLease(this, engine);
+}
+
+void OcrEnginePool::release(tesseract::TessBaseAPI* engine) {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        idle.push_back(engine);
+    }
+    engineReturned.notify_one();
+}
+
+std::string OcrEnginePool::recognize(const cv::Mat& image, OcrConfidence* confidence) {
+    OcrEngineLease engine = acquire();
+    if (!engine) {
+        return "";
+    }
+    engine->SetImage(image.data, image.cols, image.rows, static_cast<int>(image.elemSize()), static_cast<int>(image.step));
+    char* raw = engine->GetUTF8Text();
+    std::string text = raw ? raw : "";
+    delete[] raw;
+    if (confidence) {
+        confidence->mean = engine->MeanTextConf();
+        confidence->leastCharacter = 0.0f;
+        std::unique_ptr<tesseract::ResultIterator> symbols(engine->GetIterator());
+        if (symbols && !symbols->Empty(tesseract::RIL_SYMBOL)) {
+            confidence->leastCharacter = 100.0f;
+            do {
+                confidence->leastCharacter = std::min(confidence->leastCharacter, symbols->Confidence(tesseract::RIL_SYMBOL));
+            } while (symbols->Next(tesseract::RIL_SYMBOL));
+        }
+    }
+    engine->Clear();
+    return text;
+}
@@ -0,0 +1,70 @@
+#ifndef OCRENGINEPOOL_H
+#define OCRENGINEPOOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <tesseract/baseapi.h>
+
+// Digits plus the separators the number parsers understand ("1,234", "-5",
+// "1.5k", "2m", "100/250"); everything else is noise for a value readout.
+static const char* const kOcrCharWhitelist = "0123456789.,-/kKMmBb";
+
+class OcrEnginePool;
+
+struct OcrConfidence {
+    int mean = 0;                 // Tesseract's mean word confidence, 0-100
+    float leastCharacter = 0.0f;  // of the least certain character, 0-100
+};
+
+// Borrowed engine; goes back to the pool when the lease is destroyed
+class OcrEngineLease {
+    OcrEnginePool* pool;
+    tesseract::TessBaseAPI* engine;
+
+public:
+    OcrEngineLease(OcrEnginePool* owner, tesseract::TessBaseAPI* api) : pool(owner), engine(api) {}
+    ~OcrEngineLease();
+
+    OcrEngineLease(const OcrEngineLease&) = delete;
+    OcrEngineLease& operator=(const OcrEngineLease&) = delete;
+    OcrEngineLease(OcrEngineLease&& other) noexcept : pool(other.pool), engine(other.engine) { other.engine = nullptr; }
+
+    tesseract::TessBaseAPI* get() const { return engine; }
+    tesseract::TessBaseAPI* operator->() const { return engine; }
+    explicit operator bool() const { return engine != nullptr; }
+};
+
+// Tesseract engines initialized once (traineddata load, numeric config) and
+// reused across frames, instead of an Init/End per capture.
+class OcrEnginePool {
+    std::mutex poolMutex;
+    std::condition_variable engineReturned;
+    std::vector<std::unique_ptr<tesseract::TessBaseAPI>> engines;
+    std::vector<tesseract::TessBaseAPI*> idle;
+    bool initialized = false;
+
+    friend class OcrEngineLease;
+    void release(tesseract::TessBaseAPI* engine);
+
+public:
+    ~OcrEnginePool();
+
+    // Loads `count` engines from tessdataPath; later calls are no-ops once it succeeded
+    bool init(const std::string& tessdataPath, const std::string& language = "eng", size_t count = 2);
+    bool isInitialized();
+    size_t size();
+
+    // Blocks until an engine is free
+    OcrEngineLease acquire();
+
+    // Recognizes one 8-bit single-channel image with a pooled engine
+    std::string recognize(const cv::Mat& image, OcrConfidence* confidence = nullptr);
+};
+
+extern OcrEnginePool ocrEngines;
+
+#endif
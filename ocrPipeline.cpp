@@ -0,0 +1,364 @@
+#include "ocrPipeline.h"
+#include "shareInfo.h"
+#include "errorHandler.h"
+#include "ocrEnginePool.h"
+//=====================//
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <thread>
+
+static const size_t kPipelineStatsInterval = 60; // captured frames between stats reports
+static const char* const kStageNames[] = { "capture", "preprocess", "recognize", "parse", "search" };
+
+using PipelineClock = std::chrono::steady_clock;
+
+// Also charges the stage's time to the frame, for the capture scheduler's CPU budget
+static void recordBusy(StageStats& stats, PipelineClock::time_point started, FrameTiming& timing) {
+    PipelineClock::duration busy = PipelineClock::now() - started;
+    timing.work += busy;
+    stats.processed.fetch_add(1, std::memory_order_relaxed);
+    stats.busyMicros.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(busy).count(), std::memory_order_relaxed);
+}
+
+// Glyph reads space numbers apart and Tesseract ends lines with a newline; only the characters count
+static bool sameCharacters(const std::string& a, const std::string& b) {
+    auto isText = [](char c) { return !std::isspace(static_cast<unsigned char>(c)); };
+    std::string left, right;
+    std::copy_if(a.begin(), a.end(), std::back_inserter(left), isText);
+    std::copy_if(b.begin(), b.end(), std::back_inserter(right), isText);
+    return left == right;
+}
+
+OcrPipeline::OcrPipeline(FrameSource& frames, bool verboseLogging, const ReadingVoteConfig& voting)
+    : source(frames), verbose(verboseLogging), lossless(!frames.isLive()), voteConfig(voting) {}
+
+bool OcrPipeline::forward(DropOldestQueue<PipelineItem>& queue, PipelineItem&& item) {
+    return lossless ? queue.pushWait(std::move(item)) : queue.push(std::move(item));
+}
+
+void OcrPipeline::run() {
+    // The recognize thread reads one region itself, so one engine needs no helpers
+    size_t helpers = std::max<size_t>(ocrEngines.size(), 1) - 1;
+    for (size_t i = 0; i < helpers; ++i) {
+        recognizers.emplace_back(&OcrPipeline::runRecognizer, this);
+    }
+    std::thread preprocess(&OcrPipeline::runPreprocess, this);
+    std::thread recognize(&OcrPipeline::runRecognize, this);
+    std::thread parse(&OcrPipeline::runParse, this);
+    std::thread search(&OcrPipeline::runSearch, this);
+
+    auto started = PipelineClock::now();
+    runCapture();
+
+    // Close front to back so every stage drains what is already queued
+    toPreprocess.close();
+    preprocess.join();
+    toRecognize.close();
+    recognize.join();
+    regionWork.close();
+    for (std::thread& recognizer : recognizers) {
+        recognizer.join();
+    }
+    recognizers.clear();
+    toParse.close();
+    parse.join();
+    toSearch.close();
+    search.join();
+    scans.waitIdle();
+
+    if (!source.isLive()) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(PipelineClock::now() - started);
+        size_t frames = stats[static_cast<size_t>(PipelineStage::Capture)].processed.load();
+        double seconds = std::max<long long>(elapsed.count(), 1) / 1000.0;
+        reportStats("Replay finished: " + std::to_string(frames) + " frames in " + std::to_string(elapsed.count()) + " ms (" +
+                    std::to_string(static_cast<int>(frames / seconds)) + " frames/s).");
+    }
+}
+
+void OcrPipeline::runCapture() {
+    StageStats& captureStats = stats[static_cast<size_t>(PipelineStage::Capture)];
+    size_t lastReported = 0;
+
+    while (isRunning.load()) {
+        if (source.isLive() && shareInfo.isDragging.load()) {
+            std::this_thread::sleep_for(scheduler.currentInterval());
+            continue;
+        }
+
+        auto started = PipelineClock::now();
+        Frame frame;
+        if (source.next(frame)) {
+            PipelineItem item;
+            item.timing = scheduler.frameCaptured(started);
+            recordBusy(captureStats, started, item.timing);
+            if (frame.regions.empty()) {
+                item.regions.push_back({ "", frame.image });
+            }
+            for (const FrameRegion& region : frame.regions) {
+                item.regions.push_back({ region.name, frame.image(region.area) }); // views, no copy
+            }
+            frame.image.release();
+            item.timestamp = frame.timestamp;
+            item.label = std::move(frame.label);
+            forward(toPreprocess, std::move(item));
+        } else if (!source.isLive()) {
+            break; // end of the recording
+        }
+
+        size_t frames = captureStats.processed.load(std::memory_order_relaxed);
+        if (verbose && source.isLive() && frames >= lastReported + kPipelineStatsInterval) {
+            lastReported = frames;
+            reportStats("OCR pipeline after " + std::to_string(frames) + " frames:");
+        }
+
+        // The interval is set by whichever stage finishes each frame
+        if (source.isLive()) {
+            std::this_thread::sleep_for(scheduler.currentInterval());
+        }
+    }
+}
+
+void OcrPipeline::runPreprocess() {
+    StageStats& stageStats = stats[static_cast<size_t>(PipelineStage::Preprocess)];
+    PipelineItem item;
+    while (toPreprocess.pop(item)) {
+        auto started = PipelineClock::now();
+        item.unchanged = true;
+        for (RegionReading& region : item.regions) {
+            // Small HUD text is scaled up before OCR; the tracked box keeps that cheap
+            RegionPreprocessing& state = regionPreprocessing.try_emplace(region.name, shareInfo.minOcrHeight.load()).first->second;
+            cv::Rect area = state.bounds.searchArea(region.image.size());
+            cv::Mat processed = state.preprocessor.process(region.image(area));
+            cv::Rect text;
+            if (!state.bounds.locate(processed, area, text)) {
+                // The text left its tracked box: search the whole region again, this frame
+                area = cv::Rect(0, 0, region.image.cols, region.image.rows);
+                processed = state.preprocessor.process(region.image);
+                state.bounds.locate(processed, area, text);
+            }
+            processed = processed(text); // recognition only sees the text and a little background
+
+            // Same pixels as the region's last recognized frame means the same text
+            region.unchanged = state.changes.isUnchanged(processed);
+            if (region.unchanged) {
+                ++unchangedReads;
+            }
+            item.unchanged = item.unchanged && region.unchanged;
+            region.image = region.unchanged ? cv::Mat() : processed; // the capture buffer goes back to the source
+        }
+        recordBusy(stageStats, started, item.timing);
+        forward(toRecognize, std::move(item));
+    }
+}
+
+void OcrPipeline::runRecognize() {
+    StageStats& stageStats = stats[static_cast<size_t>(PipelineStage::Recognize)];
+    PipelineItem item;
+    while (toRecognize.pop(item)) {
+        auto started = PipelineClock::now();
+        // The first changed region is read on this thread, the others by the
+        // recognizer threads alongside it
+        RegionReading* first = nullptr;
+        for (RegionReading& region : item.regions) {
+            if (region.unchanged) {
+                continue;
+            }
+            if (!first) {
+                first = &region;
+            } else if (recognizers.empty()) {
+                recognizeRegion(region);
+            } else {
+                {
+                    std::lock_guard<std::mutex> lock(regionsMutex);
+                    ++regionsPending;
+                }
+                regionWork.push(&region);
+            }
+        }
+        if (first) {
+            recognizeRegion(*first);
+        }
+        {
+            std::unique_lock<std::mutex> lock(regionsMutex);
+            regionsDone.wait(lock, [this] { return regionsPending == 0; });
+        }
+        recordBusy(stageStats, started, item.timing);
+        forward(toParse, std::move(item));
+    }
+}
+
+void OcrPipeline::runRecognizer() {
+    RegionReading* region;
+    while (regionWork.pop(region)) {
+        try {
+            recognizeRegion(*region);
+        }
+        catch (const std::exception& e) {
+            // The recognize stage is waiting on this region either way
+            LOG_ERROR(std::string("Region recognition failed: ") + e.what());
+            region->text.clear();
+        }
+        std::lock_guard<std::mutex> lock(regionsMutex);
+        if (--regionsPending == 0) {
+            regionsDone.notify_one();
+        }
+    }
+}
+
+void OcrPipeline::recognizeRegion(RegionReading& region) {
+    // Both readers throw cv::Exception on a degenerate region; either way it reads as nothing
+    try {
+        // HUD counters use one fixed font, so once its glyphs are known template
+        // matching reads them in well under a millisecond
+        GlyphReadout fast = glyphs.recognize(region.image);
+        bool confident = GlyphRecognizer::isConfident(fast);
+        if (confident && !glyphs.dueForCrossCheck()) {
+            ++glyphReads;
+            region.text = fast.text;
+            region.confidence = fast.confidence;
+        } else {
+            OcrConfidence confidence;
+            region.text = ocrEngines.recognize(region.image, &confidence);
+            region.confidence = confidence.leastCharacter / 100.0f;
+            ++tesseractReads;
+            if (confident && !sameCharacters(region.text, fast.text)) {
+                ++glyphCorrections;
+                if (verbose) {
+                    LOG_INFO("Glyph templates read '" + fast.text + "' where Tesseract read '" + region.text + "'.");
+                }
+            }
+            if (confidence.mean >= kGlyphLearnConfidence) {
+                glyphs.learn(region.image, region.text);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        LOG_FATAL(std::string("OCR error: ") + e.what());
+        region.text.clear();
+        region.confidence = 0.0f;
+    }
+    region.image.release();
+}
+
+void OcrPipeline::runParse() {
+    StageStats& stageStats = stats[static_cast<size_t>(PipelineStage::Parse)];
+    PipelineItem item;
+    while (toParse.pop(item)) {
+        auto started = PipelineClock::now();
+        item.unchanged = true;
+        for (RegionReading& region : item.regions) {
+            ReadingVote& vote = votes.try_emplace(region.name, voteConfig).first->second;
+            bool won;
+            if (region.unchanged) {
+                won = vote.repeat(); // same pixels, same reading
+            } else {
+                size_t rejectedBefore = vote.rejectedCount();
+                won = vote.add(region.text, region.confidence);
+                if (vote.rejectedCount() != rejectedBefore) {
+                    ++rejectedReads;
+                    if (verbose) {
+                        std::string where = region.name.empty() ? "" : " in region '" + region.name + "'";
+                        LOG_INFO(region.text.empty() ? "Failed to capture or process text" + where + "."
+                                                     : "Holding back low-confidence reading '" + region.text + "'" + where + ".");
+                    }
+                }
+            }
+
+            // Only a text that won the vote is new to the search stage
+            region.unchanged = !won;
+            if (won) {
+                region.text = vote.confirmed();
+            }
+            item.unchanged = item.unchanged && region.unchanged;
+        }
+        recordBusy(stageStats, started, item.timing);
+
+        // Unchanged readings only matter to correlation, which samples memory every tick
+        if (item.unchanged && !shareInfo.correlationRefine.load()) {
+            finishFrame(item);
+            continue;
+        }
+        forward(toSearch, std::move(item));
+    }
+}
+
+void OcrPipeline::runSearch() {
+    StageStats& stageStats = stats[static_cast<size_t>(PipelineStage::Search)];
+    PipelineItem item;
+    while (toSearch.pop(item)) {
+        auto started = PipelineClock::now();
+        std::string where = item.label.empty() ? "" : "[" + item.label + " @" + std::to_string(item.timestamp.count()) + " ms] ";
+        const RegionReading& selection = item.regions.front();
+        if (!selection.unchanged) {
+            if (verbose) {
+                LOG_INFO(where + "Captured text: " + selection.text);
+            }
+            shareInfo.updateTheString(selection.text);
+        }
+        // Scans run on the scan service's workers; replay waits so every frame is searched
+        std::vector<std::shared_future<ScanOutcome>> submitted;
+        if (!selection.unchanged || shareInfo.correlationRefine.load()) {
+            submitted.push_back(scans.submitSelection());
+        }
+
+        std::vector<std::pair<std::string, std::string>> watched;
+        for (size_t i = 1; i < item.regions.size(); ++i) {
+            const RegionReading& region = item.regions[i];
+            if (region.unchanged) {
+                continue;
+            }
+            if (verbose) {
+                LOG_INFO(where + "Captured text in '" + region.name + "': " + region.text);
+            }
+            watched.emplace_back(region.name, region.text);
+        }
+        if (!watched.empty()) {
+            submitted.push_back(scans.submitRegions(watched));
+        }
+        if (lossless) {
+            for (const auto& outcome : submitted) {
+                outcome.wait();
+            }
+        }
+        recordBusy(stageStats, started, item.timing);
+        finishFrame(item);
+    }
+}
+
+void OcrPipeline::finishFrame(const PipelineItem& item) {
+    if (!source.isLive()) {
+        return; // replay is not paced
+    }
+    // Readings not yet handed to the scan service and scans it has not finished count as backlog
+    scheduler.frameFinished(item.timing, !item.unchanged, toSearch.size() + scans.backlog());
+}
+
+void OcrPipeline::reportStats(const std::string& heading) {
+    const DropOldestQueue<PipelineItem>* inbound[] = { nullptr, &toPreprocess, &toRecognize, &toParse, &toSearch };
+
+    std::string report = heading;
+    for (size_t i = 0; i < static_cast<size_t>(PipelineStage::Count); ++i) {
+        size_t processed = stats[i].processed.load();
+        long long busy = stats[i].busyMicros.load();
+        report += std::string("\n  ") + kStageNames[i] + ": " + std::to_string(processed) + " items, " +
+                  std::to_string(processed ? busy / static_cast<long long>(processed) : 0) + " us avg";
+        if (inbound[i]) {
+            report += ", queue " + std::to_string(inbound[i]->size()) + "/" + std::to_string(inbound[i]->capacity()) +
+                      ", dropped " + std::to_string(inbound[i]->droppedCount());
+        }
+    }
+
+    report += "\n  scans: " + std::to_string(scans.backlog()) + " running or pending, " + std::to_string(scans.coalescedCount()) +
+              " requests merged into pending scans";
+
+    CaptureLatencyStats latency = scheduler.latencyStats();
+    report += "\n  " + std::to_string(unchangedReads.load()) + " unchanged region reads skipped, " + std::to_string(glyphReads.load()) +
+              " read by glyph templates, " + std::to_string(tesseractReads.load()) + " by Tesseract (" +
+              std::to_string(glyphCorrections.load()) + " correcting a confident glyph read), " +
+              std::to_string(rejectedReads.load()) + " held back as unsure";
+    if (latency.samples > 0) {
+        report += "; change-to-seen latency p50 " + std::to_string(latency.p50.count()) + " ms, p95 " + std::to_string(latency.p95.count()) + " ms";
+    }
+    LOG_INFO(report);
+}
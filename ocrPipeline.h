@@ -0,0 +1,129 @@
+#ifndef OCRPIPELINE_H
+#define OCRPIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "frameSource.h"
+#include "frameChange.h"
+#include "glyphRecognizer.h"
+#include "captureScheduler.h"
+#include "imagePreprocess.h"
+#include "textBounds.h"
+#include "dropOldestQueue.h"
+#include "boundedQueue.h"
+#include "readingVote.h"
+#include "scanService.h"
+
+enum class PipelineStage {
+    Capture,
+    Preprocess,
+    Recognize,
+    Parse,
+    Search,
+    Count
+};
+
+struct StageStats {
+    std::atomic<size_t> processed{ 0 };
+    std::atomic<long long> busyMicros{ 0 };
+};
+
+// One screen region's share of a frame: a view into the capture, then its
+// binarized pixels, then its text
+struct RegionReading {
+    std::string name; // empty for the main selection
+    cv::Mat image;
+    std::string text;
+    float confidence = 0.0f; // of the least certain character, 0-1
+    bool unchanged = false;
+};
+
+// What travels between stages. `unchanged` items (no region has new pixels or
+// text) still reach the search stage, which samples memory for correlation.
+struct PipelineItem {
+    std::vector<RegionReading> regions; // the main selection first
+    std::chrono::milliseconds timestamp{ 0 };
+    std::string label;
+    bool unchanged = false;
+    FrameTiming timing;
+};
+
+// Per-region buffers, text box and change history, owned by the preprocess stage
+struct RegionPreprocessing {
+    OcrPreprocessor preprocessor;
+    TextBoundsTracker bounds;
+    FrameChangeDetector changes;
+
+    explicit RegionPreprocessing(int minOcrHeight) : preprocessor(minOcrHeight) {}
+};
+
+// capture -> preprocess -> recognize -> parse -> search, each stage on its
+// own thread with a small lock-free queue in front of it. Live sources drop
+// the oldest queued item when a stage falls behind, so a long memory scan
+// never delays OCR (it runs on the scan service, which merges requests that
+// arrive while a scan is running) and capture keeps its own cadence; replay
+// sources wait instead, so every recorded frame is processed.
+//
+// Each frame is captured once and split into its regions, and each region
+// is narrowed to the box around its text. Regions whose pixels did not change
+// skip OCR, and the changed ones are recognized in
+// parallel by a fixed set of recognizer threads, one per pooled engine. A region's text reaches the search stage
+// only once it is confident and has won the vote over recent frames.
+class OcrPipeline {
+    FrameSource& source;
+    bool verbose;
+    bool lossless;
+
+    DropOldestQueue<PipelineItem> toPreprocess{ 4 };
+    DropOldestQueue<PipelineItem> toRecognize{ 4 };
+    DropOldestQueue<PipelineItem> toParse{ 4 };
+    DropOldestQueue<PipelineItem> toSearch{ 2 };
+
+    StageStats stats[static_cast<size_t>(PipelineStage::Count)];
+
+    // Regions the recognize stage hands to the recognizer threads; it reads
+    // one region itself and waits until the others are done
+    BoundedQueue<RegionReading*> regionWork{ 16 };
+    std::vector<std::thread> recognizers;
+    std::mutex regionsMutex;
+    std::condition_variable regionsDone;
+    size_t regionsPending = 0;
+
+    std::map<std::string, RegionPreprocessing> regionPreprocessing;
+    ReadingVoteConfig voteConfig;
+    std::map<std::string, ReadingVote> votes; // parse stage only
+    GlyphRecognizer glyphs;
+    CaptureScheduler scheduler;
+    ScanService scans;
+    std::atomic<size_t> unchangedReads{ 0 };
+    std::atomic<size_t> glyphReads{ 0 };
+    std::atomic<size_t> tesseractReads{ 0 };
+    std::atomic<size_t> glyphCorrections{ 0 }; // cross-checks where Tesseract disagreed with a confident glyph read
+    std::atomic<size_t> rejectedReads{ 0 };
+
+    bool forward(DropOldestQueue<PipelineItem>& queue, PipelineItem&& item);
+    void runCapture();
+    void runPreprocess();
+    void runRecognize();
+    void runRecognizer();
+    void recognizeRegion(RegionReading& region);
+    void runParse();
+    void runSearch();
+    void finishFrame(const PipelineItem& item);
+    void reportStats(const std::string& heading);
+
+public:
+    explicit OcrPipeline(FrameSource& frames, bool verboseLogging = false, const ReadingVoteConfig& voting = ReadingVoteConfig());
+
+    // Runs until the source ends or isRunning is cleared; capture runs on the calling thread
+    void run();
+};
+
+#endif
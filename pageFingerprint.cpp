@@ -0,0 +1,124 @@
+#include "pageFingerprint.h"
+//=====================//
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t mixRound(uint64_t acc, uint64_t word) {
+    return rotl64(acc + word * kPrime2, 31) * kPrime1;
+}
+
+// xxHash64-style: four independent lanes over 32-byte stripes keep the
+// multipliers busy, so a page hashes at memory speed.
+uint64_t hashPage(const char* data, size_t length) {
+    uint64_t lanes[4] = { kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1 };
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        uint64_t words[4];
+        std::memcpy(words, data + i, sizeof(words));
+        lanes[0] = mixRound(lanes[0], words[0]);
+        lanes[1] = mixRound(lanes[1], words[1]);
+        lanes[2] = mixRound(lanes[2], words[2]);
+        lanes[3] = mixRound(lanes[3], words[3]);
+    }
+
+    uint64_t hash = rotl64(lanes[0], 1) + rotl64(lanes[1], 7) + rotl64(lanes[2], 12) + rotl64(lanes[3], 18);
+    for (; i < length; i += 8) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, std::min<size_t>(8, length - i));
+        hash = rotl64(hash ^ mixRound(0, word), 27) * kPrime1 + kPrime3;
+    }
+
+    hash ^= length;
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+size_t PageFingerprints::pageCount() const {
+    size_t count = 0;
+    for (const auto& run : runs) {
+        count += run.hashes.size();
+    }
+    return count;
+}
+
+size_t PageFingerprints::memoryUsage() const {
+    size_t bytes = runs.capacity() * sizeof(FingerprintRun);
+    for (const auto& run : runs) {
+        bytes += run.hashes.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void PageFingerprints::addChunk(uintptr_t base, const char* data, size_t length) {
+    for (size_t offset = 0; offset < length; offset += kFingerprintPageSize) {
+        uintptr_t page = base + offset;
+        uint64_t hash = hashPage(data + offset, std::min(kFingerprintPageSize, length - offset));
+        if (runs.empty() || runs.back().firstPage + runs.back().hashes.size() * kFingerprintPageSize != page) {
+            runs.push_back({ page, {} });
+        }
+        runs.back().hashes.push_back(hash);
+    }
+}
+
+void PageFingerprints::sortRuns() {
+    std::sort(runs.begin(), runs.end(), [](const FingerprintRun& a, const FingerprintRun& b) {
+        return a.firstPage < b.firstPage;
+    });
+}
+
+std::vector<uintptr_t> diffFingerprints(const PageFingerprints& before, const PageFingerprints& after) {
+    std::vector<uintptr_t> changed;
+    size_t beforeRun = 0;
+
+    for (const auto& run : after.runs) {
+        for (size_t index = 0; index < run.hashes.size(); ++index) {
+            uintptr_t page = run.firstPage + index * kFingerprintPageSize;
+
+            // Both sides are sorted, so the cursor into `before` only moves forward
+            while (beforeRun < before.runs.size() &&
+                   before.runs[beforeRun].firstPage + before.runs[beforeRun].hashes.size() * kFingerprintPageSize <= page) {
+                ++beforeRun;
+            }
+
+            bool same = false;
+            if (beforeRun < before.runs.size() && before.runs[beforeRun].firstPage <= page) {
+                const FingerprintRun& old = before.runs[beforeRun];
+                same = old.hashes[(page - old.firstPage) / kFingerprintPageSize] == run.hashes[index];
+            }
+            if (!same) {
+                changed.push_back(page);
+            }
+        }
+    }
+    return changed;
+}
+
+std::vector<uintptr_t> filterCandidatesByPages(const std::vector<uintptr_t>& candidates, const std::vector<uintptr_t>& changedPages, bool keepChanged) {
+    std::vector<uintptr_t> kept;
+    const uintptr_t pageMask = ~static_cast<uintptr_t>(kFingerprintPageSize - 1);
+
+    for (uintptr_t address : candidates) {
+        // A 4-byte value can straddle two pages; a change to either counts
+        uintptr_t firstPage = address & pageMask;
+        uintptr_t lastPage = (address + sizeof(int32_t) - 1) & pageMask;
+        bool changed = std::binary_search(changedPages.begin(), changedPages.end(), firstPage) ||
+                       (lastPage != firstPage && std::binary_search(changedPages.begin(), changedPages.end(), lastPage));
+        if (changed == keepChanged) {
+            kept.push_back(address);
+        }
+    }
+    return kept;
+}
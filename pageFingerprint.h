@@ -0,0 +1,40 @@
+#ifndef PAGEFINGERPRINT_H
+#define PAGEFINGERPRINT_H
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+static const size_t kFingerprintPageSize = 4096;
+
+// One 64-bit hash per 4 KiB page (8 bytes per page, ~0.2% of the memory it
+// describes). Pages are grouped into runs of consecutive pages so the page
+// address is stored once per run instead of once per page.
+struct FingerprintRun {
+    uintptr_t firstPage;
+    std::vector<uint64_t> hashes;
+};
+
+struct PageFingerprints {
+    std::vector<FingerprintRun> runs; // sorted by firstPage, non-overlapping
+
+    void clear() { runs.clear(); }
+    size_t pageCount() const;
+    size_t memoryUsage() const;
+
+    // Hash [base, base + length) and append it. Chunks of one region must arrive
+    // in order; if regions arrive out of order, call sortRuns() afterwards.
+    void addChunk(uintptr_t base, const char* data, size_t length);
+    void sortRuns();
+};
+
+uint64_t hashPage(const char* data, size_t length);
+
+// Pages in `after` that are new or hash differently from `before`, sorted
+std::vector<uintptr_t> diffFingerprints(const PageFingerprints& before, const PageFingerprints& after);
+
+// Keep candidates whose page is (keepChanged) or is not (!keepChanged) in changedPages.
+// Both inputs must be sorted.
+std::vector<uintptr_t> filterCandidatesByPages(const std::vector<uintptr_t>& candidates, const std::vector<uintptr_t>& changedPages, bool keepChanged);
+
+#endif
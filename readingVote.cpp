@@ -0,0 +1,61 @@
+#include "readingVote.h"
+//=====================//
+#include <algorithm>
+#include <cctype>
+
+// Tesseract ends a line with a newline and may pad it; glyph reads separate
+// numbers by one space. Trimmed, with each whitespace run as one space, the
+// two engines' readings of the same value are the same string.
+static std::string normalizeReading(const std::string& text) {
+    std::string normalized;
+    bool pendingSpace = false;
+    for (char c : text) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            normalized += ' ';
+            pendingSpace = false;
+        }
+        normalized += c;
+    }
+    return normalized;
+}
+
+bool ReadingVote::add(const std::string& text, float confidence) {
+    std::string reading = normalizeReading(text);
+    if (reading.empty() || confidence < config.minConfidence) {
+        ++rejected;
+        lastReading.clear(); // the pixels on screen now are the unsure ones
+        return false;
+    }
+    lastReading = reading;
+    lastConfidence = confidence;
+    recent.push_back(std::move(reading));
+    while (recent.size() > std::max<size_t>(config.window, 1)) {
+        recent.pop_front();
+    }
+    return tally();
+}
+
+bool ReadingVote::repeat() {
+    if (lastReading.empty()) {
+        return false;
+    }
+    return add(lastReading, lastConfidence);
+}
+
+bool ReadingVote::tally() {
+    const std::string& candidate = recent.back();
+    if (candidate == value) {
+        return false;
+    }
+    size_t votes = static_cast<size_t>(std::count(recent.begin(), recent.end(), candidate));
+    size_t needed = std::clamp<size_t>(config.quorum, 1, std::max<size_t>(config.window, 1));
+    if (votes < needed) {
+        return false;
+    }
+    value = candidate;
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef READINGVOTE_H
+#define READINGVOTE_H
+
+#include <deque>
+#include <string>
+#include <stddef.h>
+
+struct ReadingVoteConfig {
+    float minConfidence = 0.75f; // least certain character of an accepted reading, 0-1
+    size_t window = 3;           // recent accepted readings that vote
+    size_t quorum = 2;           // matching votes a new value needs
+};
+
+// Holds back an OCR reading until it is both confident and stable. Readings
+// whose least certain character is below minConfidence never vote; a text
+// becomes the region's value once `quorum` of the last `window` accepted
+// readings agree on it. One misread digit therefore cannot start a refine
+// that throws away the right candidates. Readings vote trimmed, with each
+// whitespace run as one space, so glyph and Tesseract reads can agree.
+class ReadingVote {
+    ReadingVoteConfig config;
+    std::deque<std::string> recent;
+    std::string lastReading; // most recent accepted reading
+    float lastConfidence = 0.0f;
+    std::string value;       // last text that won a vote
+    size_t rejected = 0;
+
+    bool tally();
+
+public:
+    explicit ReadingVote(const ReadingVoteConfig& settings = ReadingVoteConfig()) : config(settings) {}
+
+    // Both return true when the reading makes a different text the winner
+    bool add(const std::string& text, float confidence);
+    // Unchanged pixels: the last reading votes again, unless it was rejected
+    bool repeat();
+
+    const std::string& confirmed() const { return value; }
+    size_t rejectedCount() const { return rejected; }
+};
+
+#endif
@@ -2,20 +2,307 @@
 #include "shareInfo.h"
 #include "errorHandler.h"
 #include "valueSearch.h"
+#include "displayMatch.h"
+#include "addressAnchor.h"
+#include "regionStats.h"
+#include "numberTokens.h"
 //=====================//
 #include <windows.h>
-#include <regex>
 #include <string>
 #include <vector>
 #include <limits>
 #include <system_error>
 #include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
 
 regiex_In regiexIn;
 
-void regiex_In::ReturnFromRex() {
-    const std::regex number_pattern(R"(\d+)");
+static const size_t kPageFilterThreshold = 1 << 16;
+static const size_t kMaxCorrelatedCandidates = 1 << 20;
+
+// Memory as of an Encoded initial scan, held until the next reading derives offsets and XOR keys from it
+static SnapshotStore encodingBaseline(2);
+static DWORD encodingBaselinePid = 0;
+static int encodingBaselineValue = INT_MIN;
+
+// The target the stored anchors were built in, and whether re-acquired addresses still await their first refine
+static DWORD anchoredPid = 0;
+static bool anchorsOnTrial = false;
+
+// The target and displayed value the stored page fingerprints were taken at
+static DWORD fingerprintPid = 0;
+static int fingerprintValue = INT_MIN;
+
+// Sorted and unique: an address can be a hit under several encodings
+static std::vector<uintptr_t> addressesOf(const std::vector<EncodedHit>& hits) {
+    std::vector<uintptr_t> addresses;
+    addresses.reserve(hits.size());
+    for (const auto& hit : hits) {
+        addresses.push_back(hit.address);
+    }
+    std::sort(addresses.begin(), addresses.end());
+    addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+    return addresses;
+}
+
+// The first number of the text; false when there is none or it is not an exact whole int ("12.5k" is not)
+static bool firstNumberIn(const std::string& text, int& value) {
+    std::vector<NumberToken> tokens = tokenizeNumbers(text, shareInfo.getNumberLocale());
+    return !tokens.empty() && tokens.front().type != NumberType::Scaled && tokens.front().toInt(value);
+}
+
+// secondary holds the other numbers of a value line like "100/250"; they are
+// matched in the same pass and tracked alongside the first. A full int scan
+// follows the selection's text while it runs, so value ends as the one the
+// candidates hold now.
+static std::vector<uintptr_t> initialScanForValue(DWORD pid, int& value, ScanValueType valueType, const std::vector<int>& secondary) {
+    encodingBaseline.clear();
+    anchorsOnTrial = false;
+    if (valueType == ScanValueType::Encoded) {
+        std::vector<EncodedHit> hits = searchMemoryForEncoded(pid, value, shareInfo.getEncodings(), true, &encodingBaseline);
+        encodingBaselinePid = pid;
+        encodingBaselineValue = value;
+        shareInfo.updateEncodedCandidates(hits);
+        return addressesOf(hits);
+    }
+    // After a target restart, addresses found last time are usually one module
+    // lookup and a short signature search away; only fall back to a full scan
+    // if none of them still holds the value. Within the same target the
+    // addresses themselves were already refined away, so anchors cannot help.
+    std::vector<AddressAnchor> anchors = shareInfo.getAddressAnchors();
+    if (!anchors.empty() && pid != anchoredPid) {
+        auto started = std::chrono::steady_clock::now();
+        std::vector<uintptr_t> reacquired = reacquireAddresses(pid, anchors);
+        std::vector<int32_t> values = sampleCandidateValues(pid, reacquired, false);
+        std::vector<uintptr_t> confirmed;
+        for (size_t i = 0; i < reacquired.size(); ++i) {
+            if (values[i] == value) {
+                confirmed.push_back(reacquired[i]);
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        if (!confirmed.empty()) {
+            LOG_INFO("Re-acquired " + std::to_string(confirmed.size()) + " of " + std::to_string(anchors.size()) +
+                     " anchored addresses in " + std::to_string(elapsed.count()) + " ms; skipping full scan.");
+            anchoredPid = pid;
+            anchorsOnTrial = true;
+            // Secondary values were not part of the anchors; trackSecondaryValues scans for them
+            shareInfo.updateSecondaryValues({});
+            return confirmed;
+        }
+        LOG_INFO("Anchored re-acquisition found nothing in " + std::to_string(elapsed.count()) + " ms; falling back to full scan.");
+    }
+
+    PageFingerprints fingerprints;
+    CandidateStore store(shareInfo.candidateBudgetBytes.load());
+    ExtraValueScan extras{ secondary, {} };
+    // Requests queued behind this scan only see its result, so a value change
+    // that arrives meanwhile is applied to the matches found so far instead
+    std::string scannedText = shareInfo.getTheString();
+    auto followSelection = [&scannedText](int& next) {
+        std::string text = shareInfo.getTheString();
+        if (text == scannedText) {
+            return false;
+        }
+        scannedText = text;
+        return firstNumberIn(text, next);
+    };
+    searchMemoryForInt(pid, value, store, true, &fingerprints, [](const std::vector<uintptr_t>& provisional) {
+        // Candidates from hot regions become visible while the cold regions are still being read
+        shareInfo.updateVoidPoitersFinaly(provisional);
+    }, secondary.empty() ? nullptr : &extras, followSelection);
+    shareInfo.updatePageFingerprints(fingerprints);
+
+    std::vector<TrackedValue> tracked;
+    for (size_t i = 0; i < secondary.size(); ++i) {
+        tracked.push_back({ secondary[i], std::move(extras.hits[i]) });
+    }
+    shareInfo.updateSecondaryValues(tracked);
+    fingerprintPid = pid;
+    fingerprintValue = value;
+
+    // Past the budget the candidates stay on disk and the in-memory list is left empty
+    if (store.spilled()) {
+        shareInfo.updateSpilledCandidates(std::move(store));
+        return {};
+    }
+    shareInfo.updateSpilledCandidates(CandidateStore());
+    return store.toVector();
+}
+
+// Every number on the line after the first; tokens that are not exact whole ints
+// (decimals, or "12.5k", which only says the value is within 50 of 12500) are skipped
+static std::vector<int> parseSecondaryNumbers(const std::vector<NumberToken>& tokens, const std::string& text) {
+    std::vector<int> numbers;
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        int value = 0;
+        if (tokens[i].type != NumberType::Scaled && tokens[i].toInt(value)) {
+            numbers.push_back(value);
+        } else {
+            LOG_WARNING("Ignoring OCR number that is not a whole int: '" + text.substr(tokens[i].offset, tokens[i].length) + "'.");
+        }
+    }
+    return numbers;
+}
+
+static void trackSecondaryValues(DWORD pid, const std::vector<int>& secondary) {
+    std::vector<TrackedValue> tracked = shareInfo.getSecondaryValues();
+    if (secondary.empty()) {
+        if (!tracked.empty()) {
+            shareInfo.updateSecondaryValues({});
+        }
+        return;
+    }
+
+    // The line gained or lost numbers: rescan just those, still in one pass
+    if (tracked.size() != secondary.size()) {
+        std::vector<std::vector<uintptr_t>> hits = searchMemoryForInts(pid, secondary, true);
+        tracked.clear();
+        for (size_t i = 0; i < secondary.size(); ++i) {
+            tracked.push_back({ secondary[i], std::move(hits[i]) });
+        }
+        shareInfo.updateSecondaryValues(tracked);
+        return;
+    }
+
+    // Values whose candidates ran out are searched again, all in one pass; the rest are refined
+    std::vector<size_t> changed;
+    std::vector<size_t> rescanIndex;
+    std::vector<int> rescanValues;
+    for (size_t i = 0; i < tracked.size(); ++i) {
+        if (tracked[i].value == secondary[i]) {
+            continue;
+        }
+        changed.push_back(i);
+        if (tracked[i].candidates.empty()) {
+            rescanIndex.push_back(i);
+            rescanValues.push_back(secondary[i]);
+        } else {
+            tracked[i].candidates = refineCandidates(pid, tracked[i].candidates, secondary[i], false);
+        }
+        tracked[i].value = secondary[i];
+    }
+    if (!rescanValues.empty()) {
+        LOG_INFO("Rescanning " + std::to_string(rescanValues.size()) + " secondary value(s) with no candidates left.");
+        std::vector<std::vector<uintptr_t>> hits = searchMemoryForInts(pid, rescanValues, true);
+        for (size_t k = 0; k < rescanIndex.size(); ++k) {
+            tracked[rescanIndex[k]].candidates = std::move(hits[k]);
+        }
+    }
+
+    for (size_t i : changed) {
+        LOG_INFO("Secondary value " + std::to_string(i + 1) + " changed to " + std::to_string(secondary[i]) + "; " +
+                 std::to_string(tracked[i].candidates.size()) + " candidates left.");
+        if (!tracked[i].candidates.empty() && tracked[i].candidates.size() <= 3) {
+            for (uintptr_t address : tracked[i].candidates) {
+                std::stringstream ss;
+                ss << "Secondary value " << (i + 1) << " candidate at 0x" << std::hex << address;
+                LOG_INFO(ss.str());
+            }
+        }
+    }
+    shareInfo.updateSecondaryValues(tracked);
+}
+
+// Page diffs only say which values moved when the fingerprints were taken in
+// this process while it showed a different value than it does now
+static bool fingerprintsDescribe(const PageFingerprints& before, DWORD pid, int value) {
+    return before.pageCount() > 0 && fingerprintPid == pid && fingerprintValue != INT_MIN && fingerprintValue != value;
+}
 
+static std::vector<uintptr_t> refineForValue(DWORD pid, const std::vector<uintptr_t>& candidates, int value, ScanValueType valueType) {
+    if (valueType == ScanValueType::Encoded) {
+        std::vector<EncodedHit> hits = refineEncodedCandidates(pid, shareInfo.getEncodedCandidates(), value, true);
+        if (encodingBaseline.generationCount() > 0) {
+            if (encodingBaselinePid == pid) {
+                std::vector<uintptr_t> known = addressesOf(hits);
+                for (const auto& derived : deriveEncodedHits(pid, encodingBaseline, encodingBaselineValue, value, true)) {
+                    if (!std::binary_search(known.begin(), known.end(), derived.address)) {
+                        hits.push_back(derived);
+                    }
+                }
+            }
+            encodingBaseline.clear();
+        }
+        shareInfo.updateEncodedCandidates(hits);
+        if (hits.size() <= 3) {
+            for (const auto& hit : hits) {
+                std::stringstream ss;
+                ss << "Encoded candidate 0x" << std::hex << hit.address << " stored as " << describeEncoding(hit.encoding);
+                LOG_INFO(ss.str());
+            }
+        }
+        return addressesOf(hits);
+    }
+
+    if (shareInfo.spilledCandidateCount() > 0) {
+        CandidateStore stored = shareInfo.takeSpilledCandidates();
+        CandidateStore refined(shareInfo.candidateBudgetBytes.load());
+        refineCandidateStore(pid, stored, value, refined, true);
+        if (refined.spilled()) {
+            shareInfo.updateSpilledCandidates(std::move(refined));
+            return {};
+        }
+        return refined.toVector();
+    }
+
+    // With many candidates, one fingerprint pass is cheaper than a read per
+    // address: a changed value means its page changed, so skip unchanged pages.
+    PageFingerprints before = shareInfo.getPageFingerprints();
+    if (candidates.size() > kPageFilterThreshold && fingerprintsDescribe(before, pid, value)) {
+        PageFingerprints after = fingerprintProcessMemory(pid, true);
+        std::vector<uintptr_t> changedPages = diffFingerprints(before, after);
+        regionStats.recordChangedPages(pid, changedPages);
+        std::vector<uintptr_t> onChangedPages = filterCandidatesByPages(candidates, changedPages, true);
+        shareInfo.updatePageFingerprints(after);
+        fingerprintValue = value;
+        LOG_INFO(std::to_string(changedPages.size()) + " pages changed; " + std::to_string(onChangedPages.size()) + " of " +
+                 std::to_string(candidates.size()) + " candidates left to re-read.");
+        return refineCandidates(pid, onChangedPages, value, true);
+    }
+    return refineCandidates(pid, candidates, value, true);
+}
+
+// Re-acquired addresses that do not survive the first refine were a
+// coincidental match; drop the anchors so the next scan is a full one.
+static void settleAnchorTrial(const std::vector<uintptr_t>& refined) {
+    if (!anchorsOnTrial) {
+        return;
+    }
+    anchorsOnTrial = false;
+    if (refined.empty()) {
+        LOG_INFO("Re-acquired addresses failed their first refine; dropping the address anchors.");
+        shareInfo.updateAddressAnchors({});
+    }
+}
+
+// When every candidate has been refined away, the real address still moved
+// from the fingerprinted value to this one, so its page is among those that
+// changed since. Scanning just those pages is enough; false if they are not
+// usable or hold no match, and a full scan is needed.
+static bool rescanChangedPages(DWORD pid, int value, std::vector<uintptr_t>& found) {
+    PageFingerprints before = shareInfo.getPageFingerprints();
+    if (!fingerprintsDescribe(before, pid, value)) {
+        return false;
+    }
+    PageFingerprints after = fingerprintProcessMemory(pid, true);
+    std::vector<uintptr_t> changedPages = diffFingerprints(before, after);
+    shareInfo.updatePageFingerprints(after);
+    fingerprintValue = value;
+    if (changedPages.size() > after.pageCount() / 2) {
+        return false;
+    }
+    regionStats.recordChangedPages(pid, changedPages);
+    found = searchPagesForInt(pid, changedPages, value, true);
+    LOG_INFO("Rescanned " + std::to_string(changedPages.size()) + " changed pages: " + std::to_string(found.size()) + " candidates.");
+    return !found.empty();
+}
+
+void regiex_In::ReturnFromRex() {
     std::string ocrText = shareInfo.getTheString();
     DWORD pid = shareInfo.getThePIDOfProsses();
 
@@ -24,7 +311,9 @@ void regiex_In::ReturnFromRex() {
         if (lastValue != INT_MIN) {
             LOG_INFO("ReturnFromRex: Target PID became 0, resetting search state.");
             shareInfo.updateVoidPoitersFinaly({});
+            shareInfo.updateSpilledCandidates(CandidateStore());
             shareInfo.updateLastSearchedValue(INT_MIN);
+            shareInfo.updateSecondaryValues({});
         }
         return;
     }
@@ -34,90 +323,143 @@ void regiex_In::ReturnFromRex() {
          return;
     }
 
-    auto words_begin = std::sregex_iterator(ocrText.begin(), ocrText.end(), number_pattern);
-    auto words_end = std::sregex_iterator();
-    std::string extractedNumberString;
-    for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-        extractedNumberString += i->str();
+    ScanValueType valueType = shareInfo.getScanValueType();
+    if (valueType == ScanValueType::Float || valueType == ScanValueType::Double) {
+        ReturnFromDisplayMatch(ocrText, pid, valueType);
+        return;
     }
 
-    if (!extractedNumberString.empty()) {
-        try {
-            int currentNumber = std::stoi(extractedNumberString);
-            shareInfo.updateTheINT(currentNumber);
+    // One token per number: "100/250" is 100 and 250, "-1,234" is -1234
+    std::vector<NumberToken> numberTokens;
+    tokenizeNumbers(ocrText, numberTokens, shareInfo.getNumberLocale());
 
-            int lastValue = shareInfo.getLastSearchedValue();
-            std::vector<uintptr_t> currentCandidates;
-            {
-                std::lock_guard<std::mutex> lock(shareInfo.dataMutex);
-                currentCandidates = shareInfo.voidPoitersFinaly;
-            }
+    int currentNumber = 0;
+    if (!numberTokens.empty() && numberTokens.front().type == NumberType::Scaled) {
+        // "12.5k" is anything from 12450 to 12549, so an exact int search would miss most values
+        const NumberToken& first = numberTokens.front();
+        LOG_WARNING("OCR value '" + ocrText.substr(first.offset, first.length) +
+                    "' is rounded by its suffix; switch the scan type (Ctrl+Alt+F) to float or double to match it by what is shown.");
+        shareInfo.writeValueRequestPending.store(false);
+        shareInfo.writeValueInputReady.store(false);
+        return;
+    }
+    if (!numberTokens.empty() && !numberTokens.front().toInt(currentNumber)) {
+        const NumberToken& first = numberTokens.front();
+        LOG_WARNING("OCR value '" + ocrText.substr(first.offset, first.length) +
+                    "' is not a whole number that fits an int; switch the scan type (Ctrl+Alt+F) to search for it as a float.");
+        shareInfo.writeValueRequestPending.store(false);
+        shareInfo.writeValueInputReady.store(false);
+        return;
+    }
 
-            std::vector<uintptr_t> resultingCandidates;
+    if (!numberTokens.empty()) {
+        shareInfo.updateTheINT(currentNumber);
+        std::vector<int> secondaryNumbers = valueType == ScanValueType::Int32 ? parseSecondaryNumbers(numberTokens, ocrText) : std::vector<int>();
 
-            if (currentNumber == lastValue) {
-                resultingCandidates = currentCandidates;
-            }
-            else if (lastValue == INT_MIN || currentCandidates.empty()) {
-                 if (currentCandidates.empty() && lastValue != INT_MIN) {
-                     LOG_INFO("Candidate list empty, performing new initial scan for value: " + std::to_string(currentNumber));
-                 } else {
-                     LOG_INFO("Performing initial scan for value: " + std::to_string(currentNumber));
-                 }
-                 resultingCandidates = searchMemoryForInt(pid, currentNumber, true);
-                 shareInfo.updateLastSearchedValue(currentNumber);
-            }
-            else {
-                 LOG_INFO("Value changed (" + std::to_string(lastValue) + " -> " + std::to_string(currentNumber) + "). Refining " + std::to_string(currentCandidates.size()) + " candidates.");
-                 resultingCandidates = refineCandidates(pid, currentCandidates, currentNumber, true);
-                 shareInfo.updateLastSearchedValue(currentNumber);
-            }
+        int lastValue = shareInfo.getLastSearchedValue();
+        std::vector<uintptr_t> currentCandidates;
+        {
+            std::lock_guard<std::mutex> lock(shareInfo.dataMutex);
+            currentCandidates = shareInfo.voidPoitersFinaly;
+        }
 
-            shareInfo.updateVoidPoitersFinaly(resultingCandidates);
-
-            size_t finalAddressCount = resultingCandidates.size();
-            if (finalAddressCount > 0 && finalAddressCount <= 3) {
-                 LOG_INFO("Found " + std::to_string(finalAddressCount) + " candidate addresses. Requesting user input for memory write.");
-                 shareInfo.writeValueRequestPending.store(true);
-                 shareInfo.writeValueInputReady.store(false);
-
-                 HWND hMainWindow = nullptr;
-                 {
-                     std::lock_guard<std::mutex> lock(shareInfo.dataMutex);
-                     hMainWindow = shareInfo.g_hWnd;
-                 }
-
-                 if (hMainWindow && IsWindow(hMainWindow)) {
-                    if (!PostMessage(hMainWindow, WM_APP_REQUEST_WRITE_VALUE, 0, 0)) {
-                         DWORD error = GetLastError();
-                         LOG_ERROR("Failed to post WM_APP_REQUEST_WRITE_VALUE message. Error: " + std::to_string(error));
-                         shareInfo.writeValueRequestPending.store(false);
-                    } else {
-                         LOG_INFO("Posted WM_APP_REQUEST_WRITE_VALUE to main window.");
-                    }
-                 } else {
-                     LOG_ERROR("Cannot request write value: Main window handle is invalid or NULL.");
-                     shareInfo.writeValueRequestPending.store(false);
-                 }
-            }
-            else {
-                if (finalAddressCount == 0 && currentNumber != lastValue) {
-                     LOG_INFO("No addresses remaining after scan/refinement for value " + std::to_string(currentNumber));
-                 } else if (finalAddressCount > 3 && currentNumber != lastValue) {
-                     LOG_INFO("Found " + std::to_string(finalAddressCount) + " addresses for value " + std::to_string(currentNumber) + ". Refine further. No write requested.");
-                 }
-                shareInfo.writeValueRequestPending.store(false);
-                shareInfo.writeValueInputReady.store(false);
+        std::vector<uintptr_t> resultingCandidates;
+
+        bool haveCandidates = !currentCandidates.empty() || shareInfo.spilledCandidateCount() > 0;
+        // Only while the list is exactly the one the correlator tracks; hotkeys, snapshots and
+        // rescans can replace it with another of the same size
+        bool correlating = valueType == ScanValueType::Int32 && shareInfo.correlationRefine.load() && !currentCandidates.empty() &&
+                           correlator.readingCount() > 0 && correlator.getCandidates() == currentCandidates;
+
+        if (currentNumber == lastValue) {
+            if (correlating) {
+                recordCorrelationTick(pid, currentNumber);
             }
+            resultingCandidates = currentCandidates;
+        }
+        else if (correlating) {
+             recordCorrelationTick(pid, currentNumber);
+             size_t kept = correlator.prune();
+             LOG_INFO("Value changed (" + std::to_string(lastValue) + " -> " + std::to_string(currentNumber) + "). Correlation kept " +
+                      std::to_string(kept) + " of " + std::to_string(currentCandidates.size()) + " candidates over " +
+                      std::to_string(correlator.readingCount()) + " readings.");
+             resultingCandidates = correlator.getCandidates();
+             settleAnchorTrial(resultingCandidates);
+             shareInfo.updateLastSearchedValue(currentNumber);
+        }
+        else if (lastValue == INT_MIN || !haveCandidates) {
+             bool rescanned = false;
+             if (!haveCandidates && lastValue != INT_MIN) {
+                 LOG_INFO("Candidate list empty, rescanning for value: " + std::to_string(currentNumber));
+                 rescanned = valueType == ScanValueType::Int32 && rescanChangedPages(pid, currentNumber, resultingCandidates);
+             } else {
+                 LOG_INFO("Performing initial scan for value: " + std::to_string(currentNumber));
+             }
+             if (!rescanned) {
+                 resultingCandidates = initialScanForValue(pid, currentNumber, valueType, secondaryNumbers);
+             }
+             shareInfo.updateLastSearchedValue(currentNumber);
+        }
+        else {
+             LOG_INFO("Value changed (" + std::to_string(lastValue) + " -> " + std::to_string(currentNumber) + "). Refining " + std::to_string(currentCandidates.size()) + " candidates.");
+             resultingCandidates = refineForValue(pid, currentCandidates, currentNumber, valueType);
+             settleAnchorTrial(resultingCandidates);
+             shareInfo.updateLastSearchedValue(currentNumber);
+        }
 
-        } catch (const std::invalid_argument& e) {
-             LOG_WARNING("Invalid argument during number conversion (stoi): '" + extractedNumberString + "'. Error: " + e.what());
-             shareInfo.writeValueRequestPending.store(false);
-             shareInfo.writeValueInputReady.store(false);
-        } catch (const std::out_of_range& e) {
-             LOG_WARNING("Out of range during number conversion (stoi): '" + extractedNumberString + "'. Error: " + e.what());
-             shareInfo.writeValueRequestPending.store(false);
+        trackSecondaryValues(pid, secondaryNumbers);
+
+        if (!correlating && currentNumber != lastValue && valueType == ScanValueType::Int32 &&
+            shareInfo.correlationRefine.load() && !resultingCandidates.empty() &&
+            resultingCandidates.size() <= kMaxCorrelatedCandidates) {
+            correlator.reset(resultingCandidates);
+            recordCorrelationTick(pid, currentNumber);
+        }
+
+        shareInfo.updateVoidPoitersFinaly(resultingCandidates);
+
+        size_t finalAddressCount = resultingCandidates.size();
+        if (finalAddressCount > 0 && finalAddressCount <= 3) {
+             if (valueType == ScanValueType::Int32 && currentNumber != lastValue) {
+                 shareInfo.updateAddressAnchors(buildAddressAnchors(pid, resultingCandidates));
+                 anchoredPid = pid;
+                 regionStats.recordFinalAddresses(pid, resultingCandidates);
+             }
+             LOG_INFO("Found " + std::to_string(finalAddressCount) + " candidate addresses. Requesting user input for memory write.");
+             shareInfo.writeValueRequestPending.store(true);
              shareInfo.writeValueInputReady.store(false);
+
+             HWND hMainWindow = nullptr;
+             {
+                 std::lock_guard<std::mutex> lock(shareInfo.dataMutex);
+                 hMainWindow = shareInfo.g_hWnd;
+             }
+
+             if (hMainWindow && IsWindow(hMainWindow)) {
+                if (!PostMessage(hMainWindow, WM_APP_REQUEST_WRITE_VALUE, 0, 0)) {
+                     DWORD error = GetLastError();
+                     LOG_ERROR("Failed to post WM_APP_REQUEST_WRITE_VALUE message. Error: " + std::to_string(error));
+                     shareInfo.writeValueRequestPending.store(false);
+                } else {
+                     LOG_INFO("Posted WM_APP_REQUEST_WRITE_VALUE to main window.");
+                }
+             } else {
+                 LOG_ERROR("Cannot request write value: Main window handle is invalid or NULL.");
+                 shareInfo.writeValueRequestPending.store(false);
+             }
+        }
+        else {
+            size_t spilledCount = shareInfo.spilledCandidateCount();
+            if (finalAddressCount == 0 && spilledCount > 0 && currentNumber != lastValue) {
+                 LOG_INFO(std::to_string(spilledCount) + " candidates for value " + std::to_string(currentNumber) +
+                          " held on disk past the memory budget. Refine further. No write requested.");
+             } else if (finalAddressCount == 0 && currentNumber != lastValue) {
+                 LOG_INFO("No addresses remaining after scan/refinement for value " + std::to_string(currentNumber));
+             } else if (finalAddressCount > 3 && currentNumber != lastValue) {
+                 LOG_INFO("Found " + std::to_string(finalAddressCount) + " addresses for value " + std::to_string(currentNumber) + ". Refine further. No write requested.");
+             }
+            shareInfo.writeValueRequestPending.store(false);
+            shareInfo.writeValueInputReady.store(false);
         }
     } else {
          shareInfo.writeValueRequestPending.store(false);
@@ -127,7 +469,126 @@ void regiex_In::ReturnFromRex() {
          if (lastValue != INT_MIN) {
             LOG_INFO("Resetting candidates and last searched value due to missing OCR number.");
             shareInfo.updateVoidPoitersFinaly({});
+            shareInfo.updateSpilledCandidates(CandidateStore());
             shareInfo.updateLastSearchedValue(INT_MIN);
+            shareInfo.updateSecondaryValues({});
          }
     }
 }
+
+void regiex_In::ReturnFromDisplayMatch(const std::string& ocrText, DWORD pid, ScanValueType valueType) {
+    DisplayedNumber shown;
+    if (!parseDisplayedNumber(ocrText, shown, shareInfo.getNumberLocale())) {
+        if (!shareInfo.getLastSearchedDisplay().empty()) {
+            LOG_INFO("Resetting display-matched candidates due to missing OCR number.");
+            shareInfo.updateVoidPoitersFinaly({});
+            shareInfo.updateLastSearchedDisplay("");
+        }
+        return;
+    }
+
+    // Exactly the digits shown, so 1234567 and 1234568 never share a key
+    std::ostringstream key;
+    key << std::fixed << std::setprecision(shown.decimals) << shown.value << "/" << shown.decimals << "/"
+        << std::setprecision(0) << shown.suffixScale;
+    std::string lastDisplay = shareInfo.getLastSearchedDisplay();
+    if (key.str() == lastDisplay) {
+        return;
+    }
+
+    const char* typeName = valueType == ScanValueType::Float ? "float" : "double";
+    std::vector<uintptr_t> currentCandidates = shareInfo.getVoidPoitersFinaly();
+    bool initialScan = lastDisplay.empty() || currentCandidates.empty();
+    std::vector<uintptr_t> resultingCandidates;
+
+    if (valueType == ScanValueType::Float) {
+        std::vector<FloatRange> ranges = buildFloatRanges(shown);
+        resultingCandidates = initialScan ? searchMemoryForFloat(pid, ranges, true)
+                                          : refineCandidatesFloat(pid, currentCandidates, ranges, true);
+    } else {
+        std::vector<DoubleRange> ranges = buildDoubleRanges(shown);
+        resultingCandidates = initialScan ? searchMemoryForDouble(pid, ranges, true)
+                                          : refineCandidatesDouble(pid, currentCandidates, ranges, true);
+    }
+
+    LOG_INFO(std::string(initialScan ? "Initial " : "Refined ") + typeName + " display scan for '" + key.str() +
+             "': " + std::to_string(resultingCandidates.size()) + " candidate(s).");
+
+    shareInfo.updateVoidPoitersFinaly(resultingCandidates);
+    shareInfo.updateLastSearchedDisplay(key.str());
+
+    // Memory write-back only knows how to write ints, so no write request is raised here.
+    shareInfo.writeValueRequestPending.store(false);
+    shareInfo.writeValueInputReady.store(false);
+}
+
+void regiex_In::ReturnFromRegions(const std::vector<std::pair<std::string, std::string>>& readings) {
+    DWORD pid = shareInfo.getThePIDOfProsses();
+    if (pid == 0) {
+        regionSearches.clear();
+        return;
+    }
+
+    // Forget regions the user has stopped watching
+    std::vector<WatchedRegion> watched = shareInfo.getWatchedRegions();
+    for (auto it = regionSearches.begin(); it != regionSearches.end();) {
+        bool stillWatched = std::any_of(watched.begin(), watched.end(), [&](const WatchedRegion& region) { return region.name == it->first; });
+        it = stillWatched ? std::next(it) : regionSearches.erase(it);
+    }
+
+    // Regions that need a full scan share one pass over memory; the rest refine their own candidates
+    std::vector<std::string> scanNames;
+    std::vector<int> scanValues;
+    for (const auto& [name, text] : readings) {
+        RegionSearch& search = regionSearches[name];
+        int value = 0;
+        if (!firstNumberIn(text, value)) {
+            if (search.lastValue != INT_MIN) {
+                LOG_INFO("Resetting candidates of region '" + name + "' due to missing OCR number.");
+            }
+            search = RegionSearch();
+            continue;
+        }
+        if (value == search.lastValue) {
+            continue;
+        }
+
+        if (search.lastValue == INT_MIN || search.candidates.empty()) {
+            scanNames.push_back(name);
+            scanValues.push_back(value);
+        } else {
+            search.candidates = refineCandidates(pid, search.candidates, value, false);
+            LOG_INFO("Region '" + name + "' changed (" + std::to_string(search.lastValue) + " -> " + std::to_string(value) + "); " +
+                     std::to_string(search.candidates.size()) + " candidates left.");
+        }
+        search.lastValue = value;
+    }
+
+    if (!scanValues.empty()) {
+        LOG_INFO("Performing initial scan for " + std::to_string(scanValues.size()) + " watched region(s).");
+        std::vector<std::vector<uintptr_t>> hits = searchMemoryForInts(pid, scanValues, true);
+        for (size_t i = 0; i < scanNames.size(); ++i) {
+            regionSearches[scanNames[i]].candidates = std::move(hits[i]);
+            LOG_INFO("Region '" + scanNames[i] + "' = " + std::to_string(scanValues[i]) + ": " +
+                     std::to_string(regionSearches[scanNames[i]].candidates.size()) + " candidates.");
+        }
+    }
+
+    for (const auto& [name, text] : readings) {
+        auto it = regionSearches.find(name);
+        if (it == regionSearches.end() || it->second.candidates.empty() || it->second.candidates.size() > 3) {
+            continue;
+        }
+        for (uintptr_t address : it->second.candidates) {
+            std::stringstream ss;
+            ss << "Region '" << name << "' candidate at 0x" << std::hex << address;
+            LOG_INFO(ss.str());
+        }
+    }
+}
+
+void regiex_In::recordCorrelationTick(DWORD pid, int value) {
+    CorrelationClock::time_point now = CorrelationClock::now();
+    correlator.addSample(now, sampleCandidateValues(pid, correlator.getCandidates(), false));
+    correlator.addReading(now, value);
+}
@@ -2,10 +2,33 @@
 #define REGIEXIN_H
 
 #include <string>
+#include <map>
+#include <vector>
+#include <utility>
+#include <climits>
+#include <windows.h>
+#include "shareInfo.h"
+#include "valueCorrelation.h"
+
+// Value search of one watched region; only the search stage touches it
+struct RegionSearch {
+    int lastValue = INT_MIN;
+    std::vector<uintptr_t> candidates;
+};
 
 struct regiex_In
 {
     void ReturnFromRex();
+    void ReturnFromDisplayMatch(const std::string& ocrText, DWORD pid, ScanValueType valueType);
+
+    // Watched regions whose text changed this frame, as (name, OCR text).
+    // Always an int search, independent of the main selection's value type.
+    void ReturnFromRegions(const std::vector<std::pair<std::string, std::string>>& readings);
+    std::map<std::string, RegionSearch> regionSearches;
+
+    // OCR/memory history used when shareInfo.correlationRefine is on
+    SequenceCorrelator correlator;
+    void recordCorrelationTick(DWORD pid, int value);
 };
 
 extern regiex_In regiexIn;
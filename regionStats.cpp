@@ -0,0 +1,99 @@
+#include "regionStats.h"
+//=====================//
+#include <algorithm>
+#include <vector>
+
+RegionStatistics regionStats;
+
+void RegionStatistics::resetIfNewProcess(DWORD newPid) {
+    if (newPid != pid) {
+        stats.clear();
+        pid = newPid;
+    }
+}
+
+RegionStats* RegionStatistics::regionContaining(uintptr_t address) {
+    auto it = stats.upper_bound(address);
+    if (it == stats.begin()) {
+        return nullptr;
+    }
+    --it;
+    return address < it->second.end_address ? &it->second : nullptr;
+}
+
+void RegionStatistics::recordScan(DWORD scanPid, const std::vector<MemoryRegion>& regions, const std::vector<uintptr_t>& regionsWithHits) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    resetIfNewProcess(scanPid);
+    for (const auto& region : regions) {
+        RegionStats& entry = stats[region.start_address];
+        entry.end_address = region.end_address;
+        ++entry.scans;
+        if (std::binary_search(regionsWithHits.begin(), regionsWithHits.end(), region.start_address)) {
+            ++entry.scansWithHits;
+        }
+    }
+}
+
+void RegionStatistics::recordFinalAddresses(DWORD scanPid, const std::vector<uintptr_t>& addresses) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    resetIfNewProcess(scanPid);
+    for (uintptr_t address : addresses) {
+        if (RegionStats* entry = regionContaining(address)) {
+            ++entry->finalHits;
+        }
+    }
+}
+
+void RegionStatistics::recordChangedPages(DWORD scanPid, const std::vector<uintptr_t>& sortedPages) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    resetIfNewProcess(scanPid);
+    RegionStats* last = nullptr;
+    for (uintptr_t page : sortedPages) {
+        RegionStats* entry = regionContaining(page);
+        // Count each region once per diff, not once per page
+        if (entry && entry != last) {
+            ++entry->changes;
+            last = entry;
+        }
+    }
+}
+
+double RegionStatistics::priority(uintptr_t regionStart) const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    auto it = stats.find(regionStart);
+    if (it == stats.end() || it->second.scans == 0) {
+        return 0.0;
+    }
+    const RegionStats& entry = it->second;
+    double hitRate = static_cast<double>(entry.scansWithHits) / entry.scans;
+    return entry.finalHits * 1000.0 + entry.changes * 10.0 + hitRate;
+}
+
+size_t RegionStatistics::prioritize(DWORD scanPid, std::vector<MemoryRegion>& regions) {
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        resetIfNewProcess(scanPid);
+        if (stats.empty()) {
+            return 0;
+        }
+    }
+
+    std::vector<std::pair<double, MemoryRegion>> ranked;
+    ranked.reserve(regions.size());
+    for (const auto& region : regions) {
+        ranked.push_back({ priority(region.start_address), region });
+    }
+    // Stable so equally ranked regions keep address order
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+
+    size_t hot = 0;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        regions[i] = ranked[i].second;
+        if (ranked[i].first >= 10.0) {
+            ++hot;
+        }
+    }
+    return hot;
+}
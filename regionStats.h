@@ -0,0 +1,48 @@
+#ifndef REGIONSTATS_H
+#define REGIONSTATS_H
+
+#include <windows.h>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+struct MemoryRegion {
+    uintptr_t start_address;
+    uintptr_t end_address;
+};
+
+struct RegionStats {
+    uintptr_t end_address = 0;
+    uint32_t scans = 0;        // scans that covered this region
+    uint32_t scansWithHits = 0;
+    uint32_t finalHits = 0;    // times a narrowed-down (found) address lived here
+    uint32_t changes = 0;      // fingerprint diffs that saw a page here change
+};
+
+// Per-region history for one target process, used to scan the regions where
+// values have been found before ahead of the rest.
+class RegionStatistics {
+    mutable std::mutex statsMutex;
+    std::map<uintptr_t, RegionStats> stats; // keyed by region start
+    DWORD pid = 0;
+
+    void resetIfNewProcess(DWORD newPid);
+    RegionStats* regionContaining(uintptr_t address);
+
+public:
+    // regionsWithHits: sorted start addresses of the scanned regions that produced hits
+    void recordScan(DWORD scanPid, const std::vector<MemoryRegion>& regions, const std::vector<uintptr_t>& regionsWithHits);
+    void recordFinalAddresses(DWORD scanPid, const std::vector<uintptr_t>& addresses);
+    void recordChangedPages(DWORD scanPid, const std::vector<uintptr_t>& sortedPages);
+
+    double priority(uintptr_t regionStart) const;
+
+    // Reorders regions hottest first; returns how many leading regions are "hot"
+    // (held a found address or changed before) rather than merely unvisited.
+    size_t prioritize(DWORD scanPid, std::vector<MemoryRegion>& regions);
+};
+
+extern RegionStatistics regionStats;
+
+#endif
@@ -0,0 +1,167 @@
+#include "scanService.h"
+#include "shareInfo.h"
+#include "regiexIn.h"
+#include "errorHandler.h"
+//=====================//
+#include <exception>
+
+ScanService::ScanService() {
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        lanes[lane].worker = std::thread(&ScanService::runLane, this, static_cast<Lane>(lane));
+    }
+}
+
+ScanService::~ScanService() {
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        stopping = true;
+    }
+    laneChanged.notify_all();
+    for (auto& lane : lanes) {
+        lane.worker.join();
+    }
+}
+
+// Caller holds laneMutex
+ScanService::Job& ScanService::pendingJob(Lane lane) {
+    std::unique_ptr<Job>& pending = lanes[lane].pending;
+    if (!pending) {
+        pending = std::make_unique<Job>();
+        pending->promise = std::make_shared<std::promise<ScanOutcome>>();
+        pending->future = pending->promise->get_future().share();
+    } else {
+        ++coalesced;
+    }
+    ++pending->submissions;
+    return *pending;
+}
+
+std::shared_future<ScanOutcome> ScanService::submitSelection(ScanCallback callback) {
+    std::shared_future<ScanOutcome> future;
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        Job& job = pendingJob(SelectionLane);
+        if (callback) {
+            job.callbacks.push_back(std::move(callback));
+        }
+        future = job.future;
+    }
+    laneChanged.notify_all();
+    return future;
+}
+
+std::shared_future<ScanOutcome> ScanService::submitRegions(const std::vector<std::pair<std::string, std::string>>& readings,
+                                                           ScanCallback callback) {
+    std::shared_future<ScanOutcome> future;
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        Job& job = pendingJob(RegionLane);
+        for (const auto& [name, text] : readings) {
+            job.regions[name] = text; // the newest reading of a region wins
+        }
+        if (callback) {
+            job.callbacks.push_back(std::move(callback));
+        }
+        future = job.future;
+    }
+    laneChanged.notify_all();
+    return future;
+}
+
+size_t ScanService::backlog() const {
+    std::lock_guard<std::mutex> lock(laneMutex);
+    size_t jobs = 0;
+    for (const auto& lane : lanes) {
+        jobs += (lane.busy ? 1 : 0) + (lane.pending ? 1 : 0);
+    }
+    return jobs;
+}
+
+size_t ScanService::coalescedCount() const {
+    std::lock_guard<std::mutex> lock(laneMutex);
+    return coalesced;
+}
+
+void ScanService::waitIdle() {
+    std::unique_lock<std::mutex> lock(laneMutex);
+    laneChanged.wait(lock, [this] {
+        for (const auto& lane : lanes) {
+            if (lane.busy || lane.pending) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+void ScanService::runLane(Lane lane) {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(laneMutex);
+            laneChanged.wait(lock, [&] { return stopping || lanes[lane].pending; });
+            job = std::move(lanes[lane].pending);
+            if (stopping) {
+                if (job) {
+                    ScanOutcome outcome;
+                    outcome.submissions = job->submissions;
+                    outcome.skipped = true;
+                    job->promise->set_value(outcome);
+                }
+                laneChanged.notify_all();
+                return;
+            }
+            lanes[lane].busy = true;
+        }
+
+        ScanOutcome outcome = execute(lane, *job);
+        // A throwing callback must not keep the promise unset: wait() and waitIdle() would hang
+        for (const auto& callback : job->callbacks) {
+            try {
+                callback(outcome);
+            }
+            catch (const std::exception& e) {
+                LOG_ERROR(std::string("Scan callback failed: ") + e.what());
+            }
+            catch (...) {
+                LOG_ERROR("Scan callback failed with an unknown exception.");
+            }
+        }
+        job->promise->set_value(outcome);
+
+        {
+            std::lock_guard<std::mutex> lock(laneMutex);
+            lanes[lane].busy = false;
+        }
+        laneChanged.notify_all();
+    }
+}
+
+ScanOutcome ScanService::execute(Lane lane, Job& job) {
+    ScanOutcome outcome;
+    outcome.submissions = job.submissions;
+    auto started = std::chrono::steady_clock::now();
+    try {
+        if (lane == SelectionLane) {
+            regiexIn.ReturnFromRex();
+            outcome.candidates = shareInfo.getVoidPoitersFinaly().size();
+        } else {
+            std::vector<std::pair<std::string, std::string>> readings(job.regions.begin(), job.regions.end());
+            regiexIn.ReturnFromRegions(readings);
+            for (const auto& [name, text] : job.regions) {
+                auto it = regiexIn.regionSearches.find(name);
+                if (it != regiexIn.regionSearches.end()) {
+                    outcome.candidates += it->second.candidates.size();
+                }
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR(std::string("Scan failed: ") + e.what());
+    }
+    catch (...) {
+        LOG_ERROR("Scan failed with an unknown exception.");
+    }
+    outcome.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    return outcome;
+}
@@ -0,0 +1,77 @@
+#ifndef SCANSERVICE_H
+#define SCANSERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct ScanOutcome {
+    size_t submissions = 0;                // requests coalesced into this run
+    std::chrono::milliseconds duration{ 0 };
+    size_t candidates = 0;                 // the selection's candidates afterwards, or the regions' total
+    bool skipped = false;                  // the service stopped before running it
+};
+
+using ScanCallback = std::function<void(const ScanOutcome&)>;
+
+// Runs ReturnFromRex and ReturnFromRegions on worker threads, one per lane,
+// so the OCR pipeline only hands off work and never waits on process memory.
+// Each lane holds at most one pending job. A request arriving while its lane
+// is busy merges into that job: ReturnFromRex always reads the newest text
+// from shareInfo, and region readings overwrite older ones of the same
+// region. A burst of value changes during a long scan therefore costs one
+// follow-up refine with the latest values, not one refine per change.
+class ScanService {
+    enum Lane { SelectionLane, RegionLane, LaneCount };
+
+    struct Job {
+        std::map<std::string, std::string> regions; // region lane: name -> newest text
+        std::vector<ScanCallback> callbacks;
+        std::shared_ptr<std::promise<ScanOutcome>> promise;
+        std::shared_future<ScanOutcome> future;
+        size_t submissions = 0;
+    };
+
+    struct LaneState {
+        std::unique_ptr<Job> pending;
+        bool busy = false;
+        std::thread worker;
+    };
+
+    mutable std::mutex laneMutex;
+    std::condition_variable laneChanged;
+    LaneState lanes[LaneCount];
+    bool stopping = false;
+    size_t coalesced = 0;
+
+    Job& pendingJob(Lane lane);
+    void runLane(Lane lane);
+    ScanOutcome execute(Lane lane, Job& job);
+
+public:
+    ScanService();
+    ~ScanService(); // finishes running jobs; pending ones complete as skipped
+
+    ScanService(const ScanService&) = delete;
+    ScanService& operator=(const ScanService&) = delete;
+
+    // Re-runs ReturnFromRex against whatever shareInfo holds when the job starts
+    std::shared_future<ScanOutcome> submitSelection(ScanCallback callback = nullptr);
+    // Watched regions whose text changed, as (name, OCR text)
+    std::shared_future<ScanOutcome> submitRegions(const std::vector<std::pair<std::string, std::string>>& readings,
+                                                  ScanCallback callback = nullptr);
+
+    size_t backlog() const; // running plus pending jobs
+    size_t coalescedCount() const;
+    void waitIdle();
+};
+
+#endif
@@ -3,4 +3,9 @@
 #include <windows.h>
 #include <string>
 
-void screenReaderLoop(bool verbose = false);
\ No newline at end of file
+void screenReaderLoop(bool verbose = false);
+
+class FrameSource;
+
+// Runs recorded frames through preprocessing, OCR and ReturnFromRex without pacing
+void replayFrameSource(FrameSource& source, bool verbose = false);
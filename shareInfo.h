@@ -8,10 +8,37 @@
 #include <mutex>
 #include <vector>
 #include <limits> 
+#include "valueEncoding.h"
+#include "pageFingerprint.h"
+#include "addressAnchor.h"
+#include "candidateStore.h"
+#include "numberTokens.h"
+#include "readingVote.h"
 
 #define WM_APP_REQUEST_WRITE_VALUE (WM_APP + 1)
 #define WM_APP_PERFORM_WRITE (WM_APP + 2)
 
+enum class ScanValueType {
+    Int32,   // exact int match
+    Float,   // display-aware float match
+    Double,  // display-aware double match
+    Encoded  // int stored scaled, offset or XOR'd
+};
+
+// A further number on the same OCR line (the 250 in "100/250"), narrowed
+// alongside the primary value but never offered for writing
+struct TrackedValue {
+    int value;
+    std::vector<uintptr_t> candidates;
+};
+
+// A further screen region read on every frame next to `selected` (HP next to
+// ammo, say), with a value search of its own
+struct WatchedRegion {
+    std::string name;
+    RECT rect;
+};
+
 struct State_Overlay {
     mutable std::mutex dataMutex;
 
@@ -26,10 +53,25 @@ struct State_Overlay {
     std::string userInput;
     std::vector<uintptr_t> memoryFoundPointers; 
     std::vector<uintptr_t> voidPoitersFinaly;   
+    std::vector<uintptr_t> markedCandidates;
+    std::vector<TrackedValue> secondaryValues;
+    std::vector<WatchedRegion> watchedRegions;
+    PageFingerprints pageFingerprints;
+    std::vector<AddressAnchor> addressAnchors;
+    CandidateStore spilledCandidates;
+    std::atomic<size_t> candidateBudgetBytes = kDefaultCandidateBudget;
     std::atomic<bool> writeValueRequestPending = false;
     std::atomic<bool> writeValueInputReady = false;
     std::atomic<int> valueToWrite = 0;
     std::atomic<int> lastSearchedValue = INT_MIN; 
+    std::atomic<ScanValueType> scanValueType = ScanValueType::Int32;
+    std::atomic<bool> correlationRefine = false;
+    std::atomic<int> minOcrHeight = 32; // rows below which a text box is scaled up for OCR; 0 turns it off
+    std::string lastSearchedDisplay;
+    std::vector<EncodedHit> encodedCandidates;
+    std::vector<ValueEncoding> encodings = commonEncodings();
+    NumberLocale numberLocale;
+    ReadingVoteConfig readingVoteConfig;
 
     State_Overlay();
     void update(bool visible, bool running, RECT rect, bool dragging, HWND g_h) {
@@ -50,6 +92,65 @@ struct State_Overlay {
         return voidPoitersFinaly; 
     }
 
+    void updateMarkedCandidates(const std::vector<uintptr_t>& var){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        markedCandidates = var;
+    }
+    std::vector<uintptr_t> getMarkedCandidates(){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return markedCandidates;
+    }
+
+    void updateSecondaryValues(const std::vector<TrackedValue>& var){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        secondaryValues = var;
+    }
+    std::vector<TrackedValue> getSecondaryValues(){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return secondaryValues;
+    }
+
+    void updateWatchedRegions(const std::vector<WatchedRegion>& var){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        watchedRegions = var;
+    }
+    std::vector<WatchedRegion> getWatchedRegions(){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return watchedRegions;
+    }
+
+    void updatePageFingerprints(const PageFingerprints& var){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        pageFingerprints = var;
+    }
+    PageFingerprints getPageFingerprints(){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return pageFingerprints;
+    }
+
+    void updateAddressAnchors(const std::vector<AddressAnchor>& var){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        addressAnchors = var;
+    }
+    std::vector<AddressAnchor> getAddressAnchors(){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return addressAnchors;
+    }
+
+    // Candidate sets too large for the memory budget live here instead of voidPoitersFinaly
+    void updateSpilledCandidates(CandidateStore&& var){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        spilledCandidates = std::move(var);
+    }
+    CandidateStore takeSpilledCandidates(){
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return std::move(spilledCandidates);
+    }
+    size_t spilledCandidateCount() const {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return spilledCandidates.size();
+    }
+
     void updateMemoryFoundPointers(const std::vector<uintptr_t>& var){
         std::lock_guard<std::mutex> lock(dataMutex);
         memoryFoundPointers = var;
@@ -92,6 +193,58 @@ struct State_Overlay {
         return lastSearchedValue.load();
     }
 
+    void updateScanValueType(ScanValueType type) {
+        scanValueType.store(type);
+    }
+    ScanValueType getScanValueType() const {
+        return scanValueType.load();
+    }
+
+    void updateLastSearchedDisplay(const std::string& var) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        lastSearchedDisplay = var;
+    }
+    std::string getLastSearchedDisplay() {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return lastSearchedDisplay;
+    }
+
+    void updateEncodedCandidates(const std::vector<EncodedHit>& var) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        encodedCandidates = var;
+    }
+    std::vector<EncodedHit> getEncodedCandidates() {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return encodedCandidates;
+    }
+
+    void updateEncodings(const std::vector<ValueEncoding>& var) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        encodings = var;
+    }
+    std::vector<ValueEncoding> getEncodings() {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return encodings;
+    }
+
+    void updateNumberLocale(const NumberLocale& var) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        numberLocale = var;
+    }
+    NumberLocale getNumberLocale() {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return numberLocale;
+    }
+
+    void updateReadingVoteConfig(const ReadingVoteConfig& var) {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        readingVoteConfig = var;
+    }
+    ReadingVoteConfig getReadingVoteConfig() {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        return readingVoteConfig;
+    }
+
     void updateUserInput(const std::string& var){
         std::lock_guard<std::mutex> lock(dataMutex);
         userInput = var;
@@ -0,0 +1,207 @@
+#include "snapshotStore.h"
+//=====================//
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+
+static bool isZeroPage(const char* data, size_t length) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        if (word != 0) {
+            return false;
+        }
+    }
+    for (; i < length; ++i) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char* zeroPageData() {
+    static const std::vector<char> zeroes(kFingerprintPageSize, 0);
+    return zeroes.data();
+}
+
+static const SnapshotPage* findPage(const SnapshotGeneration& gen, uintptr_t pageAddress) {
+    auto it = std::lower_bound(gen.pages.begin(), gen.pages.end(), pageAddress, [](const SnapshotPage& page, uintptr_t address) {
+        return page.address < address;
+    });
+    return (it != gen.pages.end() && it->address == pageAddress) ? &*it : nullptr;
+}
+
+uint32_t SnapshotStore::beginGeneration() {
+    building = true;
+    generations.push_back({ nextId++, {} });
+    return generations.back().id;
+}
+
+PageBlob SnapshotStore::internPage(const char* data, size_t length, uint64_t hash) {
+    auto& bucket = contentIndex[hash];
+    for (auto it = bucket.begin(); it != bucket.end();) {
+        PageBlob existing = it->lock();
+        if (!existing) {
+            it = bucket.erase(it);
+            continue;
+        }
+        if (existing->size() == length && std::memcmp(existing->data(), data, length) == 0) {
+            return existing;
+        }
+        ++it;
+    }
+    PageBlob blob = std::make_shared<const std::vector<char>>(data, data + length);
+    bucket.push_back(blob);
+    return blob;
+}
+
+void SnapshotStore::addChunk(uintptr_t base, const char* data, size_t length) {
+    if (!building) {
+        return;
+    }
+    SnapshotGeneration& current = generations.back();
+    const SnapshotGeneration* older = generations.size() >= 2 ? &generations[generations.size() - 2] : nullptr;
+
+    for (size_t offset = 0; offset < length; offset += kFingerprintPageSize) {
+        const char* page = data + offset;
+        uint32_t pageLength = static_cast<uint32_t>(std::min(kFingerprintPageSize, length - offset));
+        uintptr_t address = base + offset;
+
+        if (isZeroPage(page, pageLength)) {
+            current.pages.push_back({ address, 0, pageLength, nullptr });
+            continue;
+        }
+
+        uint64_t hash = hashPage(page, pageLength);
+        // Most pages are unchanged since the last generation, so check there before the content index
+        const SnapshotPage* before = older ? findPage(*older, address) : nullptr;
+        if (before && before->blob && before->hash == hash && before->length == pageLength &&
+            std::memcmp(before->blob->data(), page, pageLength) == 0) {
+            current.pages.push_back({ address, hash, pageLength, before->blob });
+        } else {
+            current.pages.push_back({ address, hash, pageLength, internPage(page, pageLength, hash) });
+        }
+    }
+}
+
+void SnapshotStore::endGeneration() {
+    if (!building) {
+        return;
+    }
+    building = false;
+    std::vector<SnapshotPage>& pages = generations.back().pages;
+    if (!std::is_sorted(pages.begin(), pages.end(), [](const SnapshotPage& a, const SnapshotPage& b) { return a.address < b.address; })) {
+        std::sort(pages.begin(), pages.end(), [](const SnapshotPage& a, const SnapshotPage& b) { return a.address < b.address; });
+    }
+
+    while (generations.size() > maxGenerations) {
+        generations.pop_front();
+    }
+    for (auto it = contentIndex.begin(); it != contentIndex.end();) {
+        auto& bucket = it->second;
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [](const auto& weak) { return weak.expired(); }), bucket.end());
+        it = bucket.empty() ? contentIndex.erase(it) : std::next(it);
+    }
+}
+
+void SnapshotStore::clear() {
+    generations.clear();
+    contentIndex.clear();
+    building = false;
+}
+
+const SnapshotGeneration* SnapshotStore::generation(uint32_t id) const {
+    for (const auto& gen : generations) {
+        if (gen.id == id) {
+            return &gen;
+        }
+    }
+    return nullptr;
+}
+
+const char* SnapshotStore::pageData(const SnapshotGeneration& gen, uintptr_t pageAddress, size_t* length) const {
+    const SnapshotPage* page = findPage(gen, pageAddress);
+    if (!page) {
+        return nullptr;
+    }
+    if (length) {
+        *length = page->length;
+    }
+    return page->blob ? page->blob->data() : zeroPageData();
+}
+
+bool SnapshotStore::readValue(const SnapshotGeneration& gen, uintptr_t address, void* out, size_t size) const {
+    char* dest = static_cast<char*>(out);
+    while (size > 0) {
+        uintptr_t pageAddress = address & ~static_cast<uintptr_t>(kFingerprintPageSize - 1);
+        size_t pageLength = 0;
+        const char* data = pageData(gen, pageAddress, &pageLength);
+        size_t offset = address - pageAddress;
+        if (!data || offset >= pageLength) {
+            return false;
+        }
+        size_t take = std::min(size, pageLength - offset);
+        std::memcpy(dest, data + offset, take);
+        dest += take;
+        address += take;
+        size -= take;
+    }
+    return true;
+}
+
+SnapshotStats SnapshotStore::stats() const {
+    SnapshotStats result;
+    std::unordered_set<const void*> seen;
+    for (const auto& gen : generations) {
+        for (const auto& page : gen.pages) {
+            result.rawBytes += page.length;
+            if (!page.blob) {
+                ++result.zeroPages;
+            } else if (seen.insert(page.blob.get()).second) {
+                result.storedBytes += page.blob->size();
+            } else {
+                ++result.sharedPages;
+            }
+        }
+    }
+    return result;
+}
+
+void forEachChangedValue(const SnapshotStore& store, const SnapshotGeneration& older, const SnapshotGeneration& newer,
+                         const std::function<void(uintptr_t address, int32_t oldValue, int32_t newValue)>& onChange) {
+    for (const auto& page : newer.pages) {
+        const SnapshotPage* before = findPage(older, page.address);
+        if (!before || before->blob == page.blob) {
+            continue;
+        }
+        size_t oldLength = 0;
+        const char* oldData = store.pageData(older, page.address, &oldLength);
+        const char* newData = page.blob ? page.blob->data() : zeroPageData();
+        size_t length = std::min<size_t>(oldLength, page.length);
+
+        for (size_t i = 0; i + sizeof(int32_t) <= length; i += sizeof(int32_t)) {
+            int32_t oldValue, newValue;
+            std::memcpy(&oldValue, oldData + i, sizeof(int32_t));
+            std::memcpy(&newValue, newData + i, sizeof(int32_t));
+            if (newValue != oldValue) {
+                onChange(page.address + i, oldValue, newValue);
+            }
+        }
+    }
+}
+
+std::vector<uintptr_t> findChangedValues(const SnapshotStore& store, const SnapshotGeneration& older, const SnapshotGeneration& newer, ValueChange change) {
+    std::vector<uintptr_t> changed;
+    forEachChangedValue(store, older, newer, [&](uintptr_t address, int32_t oldValue, int32_t newValue) {
+        bool keep = change == ValueChange::Changed   ? true
+                  : change == ValueChange::Increased ? newValue > oldValue
+                                                     : newValue < oldValue;
+        if (keep) {
+            changed.push_back(address);
+        }
+    });
+    return changed;
+}
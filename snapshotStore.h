@@ -0,0 +1,84 @@
+#ifndef SNAPSHOTSTORE_H
+#define SNAPSHOTSTORE_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+#include "pageFingerprint.h"
+
+using PageBlob = std::shared_ptr<const std::vector<char>>;
+
+// One page of one generation. All-zero pages carry no blob; identical pages
+// (same address in an older generation, or same content anywhere) share one.
+struct SnapshotPage {
+    uintptr_t address;
+    uint64_t hash;
+    uint32_t length;
+    PageBlob blob; // null for an all-zero page
+};
+
+struct SnapshotGeneration {
+    uint32_t id;
+    std::vector<SnapshotPage> pages; // sorted by address
+};
+
+struct SnapshotStats {
+    size_t rawBytes = 0;     // what plain copies of every generation would take
+    size_t storedBytes = 0;  // unique page data actually held
+    size_t zeroPages = 0;
+    size_t sharedPages = 0;
+};
+
+// Full-memory snapshots across several generations, deduplicated per page by
+// content hash. Keeps at most maxGenerations; older ones are dropped and their
+// pages freed once no newer generation shares them.
+class SnapshotStore {
+    std::deque<SnapshotGeneration> generations;
+    std::unordered_map<uint64_t, std::vector<std::weak_ptr<const std::vector<char>>>> contentIndex;
+    size_t maxGenerations;
+    uint32_t nextId = 0;
+    bool building = false;
+
+    PageBlob internPage(const char* data, size_t length, uint64_t hash);
+
+public:
+    explicit SnapshotStore(size_t keepGenerations = 4) : maxGenerations(keepGenerations) {}
+
+    uint32_t beginGeneration();
+    void addChunk(uintptr_t base, const char* data, size_t length);
+    void endGeneration();
+    void clear();
+
+    size_t generationCount() const { return generations.size(); }
+    const SnapshotGeneration* generation(uint32_t id) const;
+    const SnapshotGeneration* latest() const { return generations.empty() ? nullptr : &generations.back(); }
+    const SnapshotGeneration* previous() const { return generations.size() < 2 ? nullptr : &generations[generations.size() - 2]; }
+
+    // Page data at pageAddress in that generation (a shared zero page for zero
+    // pages), or nullptr if the page was not captured
+    const char* pageData(const SnapshotGeneration& gen, uintptr_t pageAddress, size_t* length = nullptr) const;
+    bool readValue(const SnapshotGeneration& gen, uintptr_t address, void* out, size_t size) const;
+
+    SnapshotStats stats() const;
+};
+
+enum class ValueChange {
+    Changed,
+    Increased,
+    Decreased
+};
+
+// Every 4-byte aligned int32 that differs between two generations, with its old and new value.
+// Pages that share a blob (or are zero in both) are skipped without a compare.
+void forEachChangedValue(const SnapshotStore& store, const SnapshotGeneration& older, const SnapshotGeneration& newer,
+                         const std::function<void(uintptr_t address, int32_t oldValue, int32_t newValue)>& onChange);
+
+// 4-byte aligned int32 addresses whose value moved between two generations.
+// Pages that share a blob (or are zero in both) are skipped without a compare.
+std::vector<uintptr_t> findChangedValues(const SnapshotStore& store, const SnapshotGeneration& older, const SnapshotGeneration& newer, ValueChange change);
+
+#endif
@@ -0,0 +1,74 @@
+// Headless checks for valueEncoding.cpp: encodings that store a value as the
+// same word must all stay attached to a hit until a later value separates them.
+//   make check
+#include "../valueEncoding.h"
+//=====================//
+#include <cstdio>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+static bool holds(const EncodingNeedle& needle, const ValueEncoding& encoding) {
+    for (const auto& candidate : needle.encodings) {
+        if (candidate == encoding) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// What refineEncodedCandidates keeps of one address's hits once the value reads newValue
+static std::vector<ValueEncoding> survivors(const EncodingNeedle& needle, int32_t storedNow, int newValue) {
+    std::vector<ValueEncoding> kept;
+    for (const auto& encoding : needle.encodings) {
+        if (encodeValue(encoding, newValue) == storedNow) {
+            kept.push_back(encoding);
+        }
+    }
+    return kept;
+}
+
+static void zeroCollapsesPlainAndScales() {
+    std::vector<ValueEncoding> encodings = commonEncodings();
+    encodings.push_back({ EncodingKind::Xor, 0x5A5A });
+    std::vector<EncodingNeedle> needles = groupEncodings(encodings, 0);
+    expect(needles.size() == 2, "value 0: Plain and the scales share one needle, the XOR key has its own");
+    expect(needles[0].stored == 0 && needles[0].encodings.size() == commonEncodings().size(), "value 0: every common encoding stays on the 0 needle");
+    expect(needles[1].stored == 0x5A5A && holds(needles[1], { EncodingKind::Xor, 0x5A5A }), "value 0: XOR needle keeps its key");
+
+    // A v*4 word reads 12 once the value is 3; only that encoding survives
+    std::vector<ValueEncoding> kept = survivors(needles[0], 12, 3);
+    expect(kept.size() == 1 && kept[0] == ValueEncoding{ EncodingKind::Scaled, 4 }, "value 0 -> 3: refine keeps only v*4");
+}
+
+static void oneCollapsesPlainAndUnitScale() {
+    std::vector<ValueEncoding> encodings = { { EncodingKind::Plain, 0 }, { EncodingKind::Scaled, 1 }, { EncodingKind::Scaled, 2 },
+                                             { EncodingKind::Offset, 6 }, { EncodingKind::Xor, 6 } };
+    std::vector<EncodingNeedle> needles = groupEncodings(encodings, 1);
+    expect(needles.size() == 3, "value 1: 1, 2 and 7 are the distinct stored words");
+    expect(needles[0].stored == 1 && needles[0].encodings.size() == 2, "value 1: Plain and v*1 share a needle");
+    expect(needles[2].stored == 7 && holds(needles[2], { EncodingKind::Offset, 6 }) && holds(needles[2], { EncodingKind::Xor, 6 }),
+           "value 1: v+6 and v^6 share a needle");
+
+    // 1 -> 3: v+6 stores 9, v^6 stores 5; each word keeps its own encoding
+    expect(survivors(needles[2], 9, 3).size() == 1 && survivors(needles[2], 9, 3)[0].kind == EncodingKind::Offset, "value 1 -> 3: 9 is v+6");
+    expect(survivors(needles[2], 5, 3).size() == 1 && survivors(needles[2], 5, 3)[0].kind == EncodingKind::Xor, "value 1 -> 3: 5 is v^6");
+    // Plain and v*1 are the same function, so both stay
+    expect(survivors(needles[0], 3, 3).size() == 2, "value 1 -> 3: Plain and v*1 cannot be told apart");
+}
+
+int main() {
+    zeroCollapsesPlainAndScales();
+    oneCollapsesPlainAndUnitScale();
+    if (failures == 0) {
+        std::printf("valueEncodingTest: all checks passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
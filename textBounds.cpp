@@ -0,0 +1,100 @@
+#include "textBounds.h"
+#include "imagePreprocess.h"
+//=====================//
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <opencv2/imgproc.hpp>
+
+static const int kMinInkArea = 2;             // specks below this are noise
+static const float kGlyphHeightShare = 0.4f;  // of the tallest component; shorter ones are marks like '-' or '.'
+static const int kMinSearchMargin = 4;
+
+TextBounds findTextBounds(const cv::Mat& binary) {
+    TextBounds bounds;
+    if (binary.empty()) {
+        return bounds;
+    }
+
+    cv::Mat labels, stats, centroids;
+    int count = cv::connectedComponentsWithStats(inkMask(binary), labels, stats, centroids, 8, CV_32S);
+
+    std::vector<cv::Rect> inner;
+    std::vector<cv::Rect> atEdge;
+    int tallest = 0;
+    for (int i = 1; i < count; ++i) { // 0 is the background
+        if (stats.at<int>(i, cv::CC_STAT_AREA) < kMinInkArea) {
+            continue;
+        }
+        cv::Rect box(stats.at<int>(i, cv::CC_STAT_LEFT), stats.at<int>(i, cv::CC_STAT_TOP), stats.at<int>(i, cv::CC_STAT_WIDTH),
+                     stats.at<int>(i, cv::CC_STAT_HEIGHT));
+        if (box.x == 0 || box.y == 0 || box.br().x >= binary.cols || box.br().y >= binary.rows) {
+            atEdge.push_back(box);
+        } else {
+            inner.push_back(box);
+            tallest = std::max(tallest, box.height);
+        }
+    }
+    if (tallest == 0) {
+        return bounds;
+    }
+
+    int glyphHeight = static_cast<int>(std::ceil(tallest * kGlyphHeightShare));
+    for (const cv::Rect& box : inner) {
+        if (box.height >= glyphHeight) {
+            bounds.box = bounds.box.empty() ? box : (bounds.box | box);
+        }
+    }
+
+    // Marks within one glyph height of the line and inside its rows belong to the number
+    cv::Rect line(bounds.box.x - tallest, bounds.box.y, bounds.box.width + 2 * tallest, bounds.box.height);
+    for (const cv::Rect& box : inner) {
+        if (box.height < glyphHeight && (box & line) == box) {
+            bounds.box |= box;
+        }
+    }
+
+    cv::Rect lineRows(0, bounds.box.y, binary.cols, bounds.box.height);
+    bounds.touchesEdge = std::any_of(atEdge.begin(), atEdge.end(), [&](const cv::Rect& box) { return (box & lineRows).area() > 0; });
+    return bounds;
+}
+
+cv::Rect TextBoundsTracker::searchArea(cv::Size region) {
+    cv::Rect whole(0, 0, region.width, region.height);
+    if (region != regionSize) {
+        regionSize = region; // the user dragged a new selection
+        tracked = cv::Rect();
+    }
+    if (tracked.empty()) {
+        return whole;
+    }
+    int margin = std::max(kMinSearchMargin, tracked.height / 2);
+    return cv::Rect(tracked.x - margin, tracked.y - margin, tracked.width + 2 * margin, tracked.height + 2 * margin) & whole;
+}
+
+bool TextBoundsTracker::locate(const cv::Mat& binary, const cv::Rect& area, cv::Rect& crop) {
+    crop = cv::Rect(0, 0, binary.cols, binary.rows);
+    bool wasTracking = !tracked.empty();
+    TextBounds bounds = findTextBounds(binary);
+    if (bounds.box.empty() || (wasTracking && bounds.touchesEdge)) {
+        tracked = cv::Rect();
+        if (wasTracking) {
+            ++expansions;
+        }
+        return !wasTracking;
+    }
+
+    // The preprocessor may have scaled the area up; track in region pixels
+    double scaleX = static_cast<double>(binary.cols) / std::max(area.width, 1);
+    double scaleY = static_cast<double>(binary.rows) / std::max(area.height, 1);
+    int left = static_cast<int>(std::floor(bounds.box.x / scaleX));
+    int top = static_cast<int>(std::floor(bounds.box.y / scaleY));
+    int right = static_cast<int>(std::ceil(bounds.box.br().x / scaleX));
+    int bottom = static_cast<int>(std::ceil(bounds.box.br().y / scaleY));
+    tracked = cv::Rect(area.x + left, area.y + top, right - left, bottom - top);
+
+    // Keep some background around the glyphs; both recognizers expect it
+    int pad = std::max(2, bounds.box.height / 2);
+    crop &= cv::Rect(bounds.box.x - pad, bounds.box.y - pad, bounds.box.width + 2 * pad, bounds.box.height + 2 * pad);
+    return true;
+}
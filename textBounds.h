@@ -0,0 +1,40 @@
+#ifndef TEXTBOUNDS_H
+#define TEXTBOUNDS_H
+
+#include <opencv2/core.hpp>
+
+struct TextBounds {
+    cv::Rect box;             // empty when no text was found
+    bool touchesEdge = false; // ink on the text's line runs into the image border
+};
+
+// The text line inside a binarized image, from its connected components:
+// the union of the glyph-height components plus small marks beside them
+// ('-', '.', ','). Components touching the border are left out of the box,
+// since in a loose selection they are frame or background.
+TextBounds findTextBounds(const cv::Mat& binary);
+
+// Shrinks a region to the text inside it and follows the text across
+// frames. Once text is found, only the box around it (plus a margin) is
+// preprocessed; when ink runs into the edge of that box, or the text
+// vanishes, the whole region is searched again.
+class TextBoundsTracker {
+    cv::Rect tracked; // text box in region coordinates; empty while searching the whole region
+    cv::Size regionSize;
+    size_t expansions = 0;
+
+public:
+    // The part of the region to preprocess this frame
+    cv::Rect searchArea(cv::Size region);
+
+    // Locates the text in `binary`, the preprocessed (possibly scaled) image
+    // of `area`. Fills `crop` with the part of `binary` to recognize and
+    // returns false when the text has left a tracked area, in which case the
+    // caller should search the whole region again.
+    bool locate(const cv::Mat& binary, const cv::Rect& area, cv::Rect& crop);
+
+    bool isTracking() const { return !tracked.empty(); }
+    size_t expansionCount() const { return expansions; }
+};
+
+#endif
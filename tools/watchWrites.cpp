@@ -0,0 +1,121 @@
+// Arms hardware write watchpoints on up to four candidate addresses of a
+// running process and reports who writes them: per-address hit counts and the
+// instruction pointers of the writing code. Linux/x86-64 only, and needs
+// ptrace permission on the target (same user with ptrace_scope 0, or root).
+//   make tools && build/tools/watchWrites <pid> <address>... [--seconds N]
+// Addresses are hex, as in the "candidate at 0x..." log lines.
+#include "../writeWatch.h"
+//=====================//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <signal.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#if defined(__linux__) && defined(__x86_64__)
+
+struct AddressReport {
+    size_t hits = 0;
+    int32_t lastValue = 0;
+    std::map<uintptr_t, size_t> writers; // instruction after the write -> count
+};
+
+static void collect(WriteWatcher& watcher, std::vector<AddressReport>& reports, std::vector<size_t>& newHits) {
+    for (const WriteEvent& event : watcher.takeEvents()) {
+        AddressReport& report = reports[event.slot];
+        ++report.hits;
+        ++newHits[event.slot];
+        report.lastValue = event.value;
+        ++report.writers[event.instruction];
+    }
+}
+
+int main(int argc, char** argv) {
+    pid_t pid = 0;
+    std::vector<uintptr_t> addresses;
+    long seconds = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::strtol(argv[++i], nullptr, 10);
+        } else if (pid == 0) {
+            pid = static_cast<pid_t>(std::strtol(arg.c_str(), nullptr, 10));
+        } else {
+            addresses.push_back(static_cast<uintptr_t>(std::strtoull(arg.c_str(), nullptr, 16)));
+        }
+    }
+    if (pid <= 0 || addresses.empty()) {
+        std::fprintf(stderr, "usage: %s <pid> <hex address>... [--seconds N]\n", argv[0]);
+        return 2;
+    }
+    if (addresses.size() > kMaxWatchpoints) {
+        std::fprintf(stderr, "Only the first %zu addresses can be watched; ignoring the rest.\n", kMaxWatchpoints);
+        addresses.resize(kMaxWatchpoints);
+    }
+
+    // Blocked before the watcher thread exists, so it inherits the mask: SIGCHLD
+    // stays with the watcher and Ctrl+C is taken by sigtimedwait below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGCHLD);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    sigset_t quitSignals;
+    sigemptyset(&quitSignals);
+    sigaddset(&quitSignals, SIGINT);
+    sigaddset(&quitSignals, SIGTERM);
+
+    WriteWatcher watcher;
+    if (!watcher.start(pid, addresses)) {
+        std::fprintf(stderr, "Could not arm watchpoints in %d: %s\n", pid, watcher.lastError().c_str());
+        return 1;
+    }
+    std::printf("Watching %zu address(es) in %d; Ctrl+C to stop.\n", addresses.size(), pid);
+
+    std::vector<AddressReport> reports(addresses.size());
+    auto started = std::chrono::steady_clock::now();
+    while (watcher.isRunning()) {
+        timespec second{ 1, 0 };
+        if (sigtimedwait(&quitSignals, nullptr, &second) > 0) {
+            break;
+        }
+        std::vector<size_t> newHits(addresses.size(), 0);
+        collect(watcher, reports, newHits);
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            if (newHits[i] > 0) {
+                std::printf("0x%zx: +%zu writes, now %d\n", static_cast<size_t>(addresses[i]), newHits[i], reports[i].lastValue);
+            }
+        }
+        std::fflush(stdout);
+        if (seconds > 0 && std::chrono::steady_clock::now() - started >= std::chrono::seconds(seconds)) {
+            break;
+        }
+    }
+    watcher.stop();
+    std::vector<size_t> newHits(addresses.size(), 0);
+    collect(watcher, reports, newHits);
+
+    // Hit counts come from the watcher, which keeps counting past the event buffer
+    std::vector<size_t> hitCounts = watcher.getHitCounts();
+    std::printf("\n");
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        std::printf("0x%zx: %zu writes\n", static_cast<size_t>(addresses[i]), hitCounts[i]);
+        for (const auto& [instruction, count] : reports[i].writers) {
+            std::printf("    writer ip 0x%zx: %zu\n", static_cast<size_t>(instruction), count);
+        }
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::fprintf(stderr, "watchWrites needs Linux on x86-64 (ptrace debug registers).\n");
+    return 1;
+}
+
+#endif
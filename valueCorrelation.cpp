@@ -0,0 +1,88 @@
+#include "valueCorrelation.h"
+//=====================//
+#include <algorithm>
+#include <vector>
+
+SequenceCorrelator::SequenceCorrelator(size_t history, std::chrono::milliseconds lag, float threshold)
+    : historyLength(history), lagTolerance(lag), minScore(threshold) {}
+
+void SequenceCorrelator::reset(const std::vector<uintptr_t>& initialCandidates) {
+    candidates = initialCandidates;
+    readings.clear();
+    sampleTimes.clear();
+    samples.clear();
+}
+
+void SequenceCorrelator::addReading(CorrelationClock::time_point time, int value) {
+    readings.push_back({ time, value });
+    while (readings.size() > historyLength) {
+        readings.pop_front();
+    }
+}
+
+void SequenceCorrelator::addSample(CorrelationClock::time_point time, const std::vector<int32_t>& values) {
+    if (values.size() != candidates.size()) {
+        return;
+    }
+    sampleTimes.push_back(time);
+    samples.push_back(values);
+    // Keep enough ticks on either side of the oldest reading's lag window
+    while (samples.size() > historyLength + 2) {
+        sampleTimes.pop_front();
+        samples.pop_front();
+    }
+}
+
+std::vector<float> SequenceCorrelator::score() const {
+    std::vector<float> scores(candidates.size(), 0.0f);
+    if (readings.empty()) {
+        return scores;
+    }
+
+    std::vector<uint8_t> matched(candidates.size());
+    std::vector<uint32_t> hits(candidates.size(), 0);
+    for (const auto& reading : readings) {
+        std::fill(matched.begin(), matched.end(), 0);
+        const int32_t expected = reading.value;
+        for (size_t tick = 0; tick < samples.size(); ++tick) {
+            auto distance = sampleTimes[tick] > reading.time ? sampleTimes[tick] - reading.time : reading.time - sampleTimes[tick];
+            if (distance > lagTolerance) {
+                continue;
+            }
+            // Branch-free inner loop over one tick's row, so it vectorizes
+            const int32_t* row = samples[tick].data();
+            for (size_t c = 0; c < candidates.size(); ++c) {
+                matched[c] |= static_cast<uint8_t>(row[c] == expected);
+            }
+        }
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            hits[c] += matched[c];
+        }
+    }
+
+    const float total = static_cast<float>(readings.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        scores[c] = hits[c] / total;
+    }
+    return scores;
+}
+
+size_t SequenceCorrelator::prune() {
+    std::vector<float> scores = score();
+
+    size_t kept = 0;
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        if (scores[c] >= minScore) {
+            candidates[kept] = candidates[c];
+            for (auto& row : samples) {
+                row[kept] = row[c];
+            }
+            ++kept;
+        }
+    }
+    candidates.resize(kept);
+    for (auto& row : samples) {
+        row.resize(kept);
+    }
+    return kept;
+}
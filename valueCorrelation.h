@@ -0,0 +1,47 @@
+#ifndef VALUECORRELATION_H
+#define VALUECORRELATION_H
+
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <stdint.h>
+
+using CorrelationClock = std::chrono::steady_clock;
+
+struct TimedReading {
+    CorrelationClock::time_point time;
+    int value;
+};
+
+// Keeps the last N OCR readings and, for the same moments, a sample of every
+// candidate's memory. A candidate is scored by how many readings it matched
+// at some sample within lagTolerance of the reading, so one frame where the
+// screen and memory disagree no longer throws the real address away.
+class SequenceCorrelator {
+    std::vector<uintptr_t> candidates;
+    std::deque<TimedReading> readings;
+    std::deque<CorrelationClock::time_point> sampleTimes;
+    std::deque<std::vector<int32_t>> samples; // samples[tick][candidate]
+
+    size_t historyLength;
+    std::chrono::milliseconds lagTolerance;
+    float minScore;
+
+public:
+    SequenceCorrelator(size_t history = 8, std::chrono::milliseconds lag = std::chrono::milliseconds(1500), float threshold = 0.75f);
+
+    void reset(const std::vector<uintptr_t>& initialCandidates);
+    const std::vector<uintptr_t>& getCandidates() const { return candidates; }
+    size_t readingCount() const { return readings.size(); }
+
+    void addReading(CorrelationClock::time_point time, int value);
+    void addSample(CorrelationClock::time_point time, const std::vector<int32_t>& values);
+
+    // Fraction of readings each candidate matched within the lag window
+    std::vector<float> score() const;
+
+    // Drop candidates scoring below the threshold; returns how many were kept
+    size_t prune();
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "valueEncoding.h"
+//=====================//
+#include <algorithm>
+#include <string>
+#include <vector>
+
+int32_t encodeValue(const ValueEncoding& encoding, int value) {
+    // Unsigned arithmetic so scaled values wrap the same way they do in the target
+    uint32_t raw = static_cast<uint32_t>(value);
+    uint32_t param = static_cast<uint32_t>(encoding.param);
+    switch (encoding.kind) {
+        case EncodingKind::Scaled: return static_cast<int32_t>(raw * param);
+        case EncodingKind::Offset: return static_cast<int32_t>(raw + param);
+        case EncodingKind::Xor:    return static_cast<int32_t>(raw ^ param);
+        case EncodingKind::Plain:
+        default:                   return value;
+    }
+}
+
+std::vector<EncodingNeedle> groupEncodings(const std::vector<ValueEncoding>& encodings, int value) {
+    std::vector<EncodingNeedle> needles;
+    for (const auto& encoding : encodings) {
+        int32_t stored = encodeValue(encoding, value);
+        auto it = std::find_if(needles.begin(), needles.end(), [&](const EncodingNeedle& needle) { return needle.stored == stored; });
+        if (it == needles.end()) {
+            needles.push_back({ stored, { encoding } });
+        } else if (std::find(it->encodings.begin(), it->encodings.end(), encoding) == it->encodings.end()) {
+            it->encodings.push_back(encoding);
+        }
+    }
+    return needles;
+}
+
+std::string describeEncoding(const ValueEncoding& encoding) {
+    switch (encoding.kind) {
+        case EncodingKind::Scaled: return "v*" + std::to_string(encoding.param);
+        case EncodingKind::Offset: return "v+" + std::to_string(encoding.param);
+        case EncodingKind::Xor:    return "v^" + std::to_string(encoding.param);
+        case EncodingKind::Plain:
+        default:                   return "v";
+    }
+}
+
+std::vector<ValueEncoding> commonEncodings() {
+    return {
+        { EncodingKind::Plain, 0 },
+        { EncodingKind::Scaled, -1 },
+        { EncodingKind::Scaled, 2 },
+        { EncodingKind::Scaled, 4 },
+        { EncodingKind::Scaled, 8 },
+        { EncodingKind::Scaled, 10 },
+        { EncodingKind::Scaled, 100 },
+        { EncodingKind::Scaled, 1000 },
+    };
+}
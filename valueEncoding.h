@@ -0,0 +1,46 @@
+#ifndef VALUEENCODING_H
+#define VALUEENCODING_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// How the target stores a value it displays as `v`
+enum class EncodingKind : uint8_t {
+    Plain,   // v
+    Scaled,  // v * param
+    Offset,  // v + param
+    Xor      // v ^ param
+};
+
+struct ValueEncoding {
+    EncodingKind kind = EncodingKind::Plain;
+    int32_t param = 0;
+
+    bool operator==(const ValueEncoding& other) const {
+        return kind == other.kind && param == other.param;
+    }
+};
+
+struct EncodedHit {
+    uintptr_t address;
+    ValueEncoding encoding;
+};
+
+// The encodings that store a value as the same word: for 0 Plain and every
+// scale agree, for 1 Plain and v*1 do. Only a later value tells them apart.
+struct EncodingNeedle {
+    int32_t stored;
+    std::vector<ValueEncoding> encodings;
+};
+
+int32_t encodeValue(const ValueEncoding& encoding, int value);
+// One needle per distinct stored word, in the order the encodings first produce it
+std::vector<EncodingNeedle> groupEncodings(const std::vector<ValueEncoding>& encodings, int value);
+std::string describeEncoding(const ValueEncoding& encoding);
+
+// Plain, negated and the usual fixed-point scales. Offsets and XOR keys are
+// target specific: append known ones, or let deriveEncodedHits find them.
+std::vector<ValueEncoding> commonEncodings();
+
+#endif
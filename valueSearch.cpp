@@ -1,6 +1,8 @@
 #include "valueSearch.h" 
 #include "shareInfo.h"
 #include "errorHandler.h"
+#include "boundedQueue.h"
+#include "regionStats.h"
 //=================//
 #include <iostream>
 #include <vector>
@@ -12,26 +14,13 @@
 #include <tlhelp32.h>
 #include <psapi.h>
 #include <algorithm> 
+#include <thread>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-std::vector<uintptr_t> searchMemoryForInt(DWORD pid, int value, bool verbose) {
-    std::vector<uintptr_t> results;
-     struct MemoryRegion {
-        uintptr_t start_address;
-        uintptr_t end_address;
-    };
+static std::vector<MemoryRegion> collectReadableRegions(HANDLE process_handle) {
     std::vector<MemoryRegion> memory_regions;
-
-    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
-    if (process_handle == NULL) {
-        if (verbose) {
-            std::stringstream ss;
-            ss << "Failed to open process " << pid << " for initial scan. Error code: " << GetLastError();
-            LOG_ERROR(ss.str());
-        }
-        return results; 
-    }
-    REGISTER_HANDLE(process_handle); 
-
     MEMORY_BASIC_INFORMATION mbi;
     LPVOID address = 0;
 
@@ -57,42 +46,529 @@ std::vector<uintptr_t> searchMemoryForInt(DWORD pid, int value, bool verbose) {
                  break;
              }
      }
+    return memory_regions;
+}
 
-     const size_t buffer_size = 65536; 
-     std::vector<char> buffer(buffer_size); 
-     size_t total_searched = 0;
-     for (const auto& region : memory_regions) {
-         uintptr_t current_address = region.start_address;
-         size_t remaining_in_region = region.end_address - current_address;
-         while (remaining_in_region >= sizeof(int)) {
-             size_t bytes_to_read = std::min(buffer_size, remaining_in_region);
-             SIZE_T bytes_read = 0;
-             bool read_success = ReadProcessMemory(process_handle, (LPCVOID)current_address, buffer.data(), bytes_to_read, &bytes_read);
-             if (read_success && bytes_read > 0) {
-                 for (size_t i = 0; i <= bytes_read - sizeof(int); ++i) {
-                      int potential_value;
-                      std::memcpy(&potential_value, buffer.data() + i, sizeof(int));
-                      if (potential_value == value) {
-                          results.push_back(current_address + i);
-                      }
+struct ScanChunk {
+    uintptr_t base;
+    size_t length;
+    size_t slot;
+};
+
+static const size_t kScanChunkSize = 256 * 1024;
+static const size_t kScanPipelineDepth = 3;
+
+// Reads every region in chunks and hands each chunk to onChunk(base, data, length).
+// A reader thread fills up to kScanPipelineDepth buffers ahead while the calling
+// thread compares earlier ones, so ReadProcessMemory and the compare loop overlap.
+// Chunks arrive in address order. If fingerprints is set, the reader also hashes
+// every page it reads into it. Returns the number of bytes read.
+template <typename ChunkFn>
+static size_t scanReadableMemory(HANDLE process_handle, const std::vector<MemoryRegion>& memory_regions, ChunkFn onChunk, PageFingerprints* fingerprints = nullptr) {
+     std::vector<std::vector<char>> buffers(kScanPipelineDepth, std::vector<char>(kScanChunkSize));
+     BoundedQueue<size_t> freeSlots(kScanPipelineDepth);
+     BoundedQueue<ScanChunk> filledChunks(kScanPipelineDepth);
+     for (size_t slot = 0; slot < kScanPipelineDepth; ++slot) {
+         freeSlots.push(slot);
+     }
+
+     std::thread reader([&]() {
+         for (const auto& region : memory_regions) {
+             uintptr_t current_address = region.start_address;
+             size_t remaining_in_region = region.end_address - current_address;
+             while (remaining_in_region >= sizeof(int)) {
+                 size_t slot;
+                 if (!freeSlots.pop(slot)) {
+                     return;
+                 }
+                 size_t bytes_to_read = std::min(kScanChunkSize, remaining_in_region);
+                 SIZE_T bytes_read = 0;
+                 bool read_success = ReadProcessMemory(process_handle, (LPCVOID)current_address, buffers[slot].data(), bytes_to_read, &bytes_read);
+                 if (!read_success || bytes_read == 0) {
+                     freeSlots.push(slot);
+                     break;
+                 }
+                 if (fingerprints) {
+                     fingerprints->addChunk(current_address, buffers[slot].data(), static_cast<size_t>(bytes_read));
+                 }
+                 if (!filledChunks.push({ current_address, static_cast<size_t>(bytes_read), slot })) {
+                     return;
                  }
                  current_address += bytes_read;
                  remaining_in_region -= bytes_read;
-                 total_searched += bytes_read;
-             } else {
-                 if (verbose && !read_success) { /* log error */ }
-                 break;
              }
          }
+         filledChunks.close();
+     });
+
+     size_t total_searched = 0;
+     try {
+         ScanChunk chunk;
+         while (filledChunks.pop(chunk)) {
+             onChunk(chunk.base, buffers[chunk.slot].data(), chunk.length);
+             total_searched += chunk.length;
+             freeSlots.push(chunk.slot);
+         }
+     } catch (...) {
+         freeSlots.close();
+         filledChunks.close();
+         reader.join();
+         throw;
      }
+     reader.join();
+     return total_searched;
+}
+
+template <typename T>
+static bool valueInRanges(T value, const std::vector<ValueRange<T>>& ranges) {
+    for (const auto& range : ranges) {
+        if (value >= range.low && value <= range.high) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Floats and doubles are scanned on 4-byte alignment. The outer [low, high]
+// test rejects almost every word before the per-interval compares run.
+template <typename T>
+static void matchRangesInChunk(uintptr_t base, const char* data, size_t length, const std::vector<ValueRange<T>>& ranges, std::vector<uintptr_t>& results) {
+    const T outerLow = ranges.front().low;
+    const T outerHigh = ranges.back().high;
+    for (size_t i = 0; i + sizeof(T) <= length; i += sizeof(float)) {
+        T potential_value;
+        std::memcpy(&potential_value, data + i, sizeof(T));
+        if (potential_value >= outerLow && potential_value <= outerHigh && valueInRanges(potential_value, ranges)) {
+            results.push_back(base + i);
+        }
+    }
+}
+
+// Up to kMaxNeedles int32 needles compared at every byte offset. With SSE2 each
+// 16-byte block is loaded at four byte shifts, so one pass of broadcast
+// compares covers all 16 offsets; hits are reported in address order.
+static const size_t kMaxNeedles = 16;
+
+template <typename HitFn>
+static void matchNeedlesInChunk(uintptr_t base, const char* data, size_t length, const int32_t* needles, size_t needleCount, HitFn onHit) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i broadcast[kMaxNeedles];
+    for (size_t k = 0; k < needleCount; ++k) {
+        broadcast[k] = _mm_set1_epi32(needles[k]);
+    }
+    for (; i + 16 + 3 <= length; i += 16) {
+        int masks[4];
+        int anyMask = 0;
+        for (int shift = 0; shift < 4; ++shift) {
+            __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + shift));
+            __m128i hits = _mm_cmpeq_epi32(words, broadcast[0]);
+            for (size_t k = 1; k < needleCount; ++k) {
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi32(words, broadcast[k]));
+            }
+            masks[shift] = _mm_movemask_epi8(hits);
+            anyMask |= masks[shift];
+        }
+        if (!anyMask) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 16; ++offset) {
+            if (masks[offset & 3] & (1 << ((offset >> 2) * 4))) {
+                int32_t potential_value;
+                std::memcpy(&potential_value, data + i + offset, sizeof(int32_t));
+                for (size_t k = 0; k < needleCount; ++k) {
+                    if (potential_value == needles[k]) {
+                        onHit(base + i + offset, k);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+#endif
+    for (; i + sizeof(int32_t) <= length; ++i) {
+        int32_t potential_value;
+        std::memcpy(&potential_value, data + i, sizeof(int32_t));
+        for (size_t k = 0; k < needleCount; ++k) {
+            if (potential_value == needles[k]) {
+                onHit(base + i, k);
+                break;
+            }
+        }
+    }
+}
+
+template <typename Sink>
+static void matchIntInChunk(uintptr_t base, const char* data, size_t length, int value, Sink& results) {
+    for (size_t i = 0; i + sizeof(int) <= length; ++i) {
+        int potential_value;
+        std::memcpy(&potential_value, data + i, sizeof(int));
+        if (potential_value == value) {
+            results.push_back(base + i);
+        }
+    }
+}
+
+// Where the int scan puts its hits: a plain vector, or a CandidateStore that
+// spills to disk past its memory budget.
+struct VectorSink {
+    std::vector<uintptr_t>& out;
+    void push_back(uintptr_t address) { out.push_back(address); }
+    size_t size() const { return out.size(); }
+    bool spilled() const { return false; }
+    void reset(std::vector<uintptr_t>&& kept) { out = std::move(kept); }
+    std::vector<uintptr_t> snapshot() const {
+        std::vector<uintptr_t> copy = out;
+        std::sort(copy.begin(), copy.end());
+        return copy;
+    }
+    void finish() { std::sort(out.begin(), out.end()); }
+};
 
+struct StoreSink {
+    CandidateStore& out;
+    void push_back(uintptr_t address) { out.push(address); }
+    size_t size() const { return out.size(); }
+    bool spilled() const { return out.spilled(); }
+    void reset(std::vector<uintptr_t>&& kept) {
+        out.clear();
+        for (uintptr_t address : kept) {
+            out.push(address);
+        }
+    }
+    std::vector<uintptr_t> snapshot() const {
+        // A spilled store is too big to be worth publishing early
+        if (out.spilled()) {
+            return {};
+        }
+        std::vector<uintptr_t> copy = out.inMemory();
+        std::sort(copy.begin(), copy.end());
+        return copy;
+    }
+    void finish() {}
+};
+
+template <typename Sink>
+static bool searchMemoryForIntInto(DWORD pid, int& value, bool verbose, PageFingerprints* fingerprints, const ProvisionalResultsFn& onProvisional, Sink& results,
+                                   ExtraValueScan* extras = nullptr, size_t extraLimit = 0, const RetargetFn& retarget = nullptr) {
+    // Needle 0 is the main value and feeds the sink; extra values that repeat share a needle
+    std::vector<int32_t> needles{ value };
+    std::vector<size_t> slot;
+    if (extras) {
+        extras->hits.assign(extras->values.size(), {});
+        slot.assign(extras->values.size(), SIZE_MAX);
+        for (size_t i = 0; i < extras->values.size(); ++i) {
+            auto it = std::find(needles.begin(), needles.end(), extras->values[i]);
+            if (it != needles.end()) {
+                slot[i] = static_cast<size_t>(it - needles.begin());
+            } else if (needles.size() < kMaxNeedles) {
+                slot[i] = needles.size();
+                needles.push_back(extras->values[i]);
+            } else if (verbose) {
+                LOG_WARNING("Multi-value scan is limited to " + std::to_string(kMaxNeedles) + " distinct values; skipping " +
+                            std::to_string(extras->values[i]) + ".");
+            }
+        }
+    }
+    bool mainIsExtra = std::find(slot.begin(), slot.end(), 0) != slot.end();
+    std::vector<std::vector<uintptr_t>> needleHits(needles.size());
+    std::vector<bool> overflowed(needles.size(), false);
+
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            std::stringstream ss;
+            ss << "Failed to open process " << pid << " for initial scan. Error code: " << GetLastError();
+            LOG_ERROR(ss.str());
+        }
+        return false; 
+    }
+    REGISTER_HANDLE(process_handle); 
+
+    std::vector<MemoryRegion> memory_regions = collectReadableRegions(process_handle);
+    if (fingerprints) {
+        fingerprints->clear();
+    }
+
+    // Regions that held found addresses or changed before are scanned first, and
+    // whatever they yield is published before the cold regions are read.
+    size_t hot_count = regionStats.prioritize(pid, memory_regions);
+    std::vector<MemoryRegion> hot_regions(memory_regions.begin(), memory_regions.begin() + hot_count);
+    std::sort(hot_regions.begin(), hot_regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) {
+        return a.start_address < b.start_address;
+    });
+    std::vector<MemoryRegion> sorted_regions = memory_regions;
+    std::sort(sorted_regions.begin(), sorted_regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) {
+        return a.start_address < b.start_address;
+    });
+    auto region_of = [](const std::vector<MemoryRegion>& regions, uintptr_t address) -> const MemoryRegion* {
+        auto it = std::upper_bound(regions.begin(), regions.end(), address, [](uintptr_t a, const MemoryRegion& r) {
+            return a < r.start_address;
+        });
+        if (it == regions.begin() || address >= std::prev(it)->end_address) {
+            return nullptr;
+        }
+        return &*std::prev(it);
+    };
+
+    bool provisional_sent = hot_count == 0 || !onProvisional;
+    bool provisional_published = false;
+    std::vector<uintptr_t> regions_with_hits;
+
+    scanReadableMemory(process_handle, memory_regions, [&](uintptr_t base, const char* data, size_t length) {
+        // A value that sits in needle 0 for an extra too cannot move without it
+        int next = value;
+        if (retarget && !mainIsExtra && !results.spilled() && retarget(next) && next != value) {
+            std::vector<uintptr_t> found = results.snapshot();
+            std::vector<int32_t> now = sampleCandidateValues(pid, found, false);
+            std::vector<uintptr_t> kept;
+            for (size_t i = 0; i < found.size(); ++i) {
+                if (now[i] == next) {
+                    kept.push_back(found[i]);
+                }
+            }
+            if (verbose) {
+                LOG_INFO("Value moved from " + std::to_string(value) + " to " + std::to_string(next) + " mid-scan; " +
+                         std::to_string(kept.size()) + " of " + std::to_string(found.size()) + " matches so far follow it.");
+            }
+            results.reset(std::move(kept));
+            value = next;
+            needles[0] = next;
+            auto same = std::find(needles.begin() + 1, needles.end(), next);
+            if (same != needles.end()) {
+                // The new value is also an extra one: needle 0 matches first, so it takes over that extra's hits
+                size_t extra = static_cast<size_t>(same - needles.begin());
+                needleHits[0] = std::move(needleHits[extra]);
+                needleHits[extra].clear();
+                overflowed[0] = overflowed[extra];
+                std::replace(slot.begin(), slot.end(), extra, size_t{ 0 });
+                mainIsExtra = true;
+            }
+            if (provisional_published) {
+                onProvisional(results.snapshot());
+            }
+        }
+
+        if (!provisional_sent && !region_of(hot_regions, base)) {
+            provisional_sent = true;
+            provisional_published = true;
+            std::vector<uintptr_t> provisional = results.snapshot();
+            if (verbose) {
+                LOG_INFO("Hot regions done: " + std::to_string(provisional.size()) + " provisional matches for value " + std::to_string(value));
+            }
+            onProvisional(provisional);
+        }
+        bool hit = false;
+        if (needles.size() == 1 && !mainIsExtra) {
+            size_t before = results.size();
+            matchIntInChunk(base, data, length, value, results);
+            hit = results.size() != before;
+        } else {
+            matchNeedlesInChunk(base, data, length, needles.data(), needles.size(), [&](uintptr_t address, size_t needle) {
+                hit = true;
+                if (needle == 0) {
+                    results.push_back(address);
+                    if (!mainIsExtra) {
+                        return;
+                    }
+                }
+                if (overflowed[needle]) {
+                    return;
+                }
+                needleHits[needle].push_back(address);
+                if (needleHits[needle].size() > extraLimit) {
+                    overflowed[needle] = true;
+                    std::vector<uintptr_t>().swap(needleHits[needle]);
+                }
+            });
+        }
+        if (hit) {
+            const MemoryRegion* region = region_of(sorted_regions, base);
+            if (region && (regions_with_hits.empty() || regions_with_hits.back() != region->start_address)) {
+                regions_with_hits.push_back(region->start_address);
+            }
+        }
+    }, fingerprints);
 
     CloseHandle(process_handle);
     UNREGISTER_HANDLE(process_handle); 
 
+    // Prioritized order is not address order; everything downstream expects sorted results
+    if (hot_count > 0) {
+        results.finish();
+        if (fingerprints) {
+            fingerprints->sortRuns();
+        }
+        for (auto& hits : needleHits) {
+            std::sort(hits.begin(), hits.end());
+        }
+    }
+    if (extras) {
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (slot[i] == SIZE_MAX) {
+                continue;
+            }
+            if (overflowed[slot[i]] && verbose) {
+                LOG_INFO("Value " + std::to_string(extras->values[i]) + " matched past its share of the candidate budget; it is searched again once it changes.");
+            }
+            extras->hits[i] = needleHits[slot[i]];
+        }
+    }
+    std::sort(regions_with_hits.begin(), regions_with_hits.end());
+    regions_with_hits.erase(std::unique(regions_with_hits.begin(), regions_with_hits.end()), regions_with_hits.end());
+    regionStats.recordScan(pid, memory_regions, regions_with_hits);
+
     if (verbose) {
         std::stringstream ss;
-        ss << "Initial scan complete. Found " << results.size() << " matches for value " << value;
+        ss << "Initial scan complete. Found " << results.size() << " matches for value " << value
+           << " (" << hot_count << " prioritized regions)";
+        LOG_INFO(ss.str());
+    }
+    return true;
+}
+
+std::vector<uintptr_t> searchMemoryForInt(DWORD pid, int value, bool verbose, PageFingerprints* fingerprints, const ProvisionalResultsFn& onProvisional) {
+    std::vector<uintptr_t> results;
+    VectorSink sink{ results };
+    searchMemoryForIntInto(pid, value, verbose, fingerprints, onProvisional, sink);
+    return results;
+}
+
+bool searchMemoryForInt(DWORD pid, int& value, CandidateStore& results, bool verbose, PageFingerprints* fingerprints, const ProvisionalResultsFn& onProvisional,
+                        ExtraValueScan* extras, const RetargetFn& retarget) {
+    results.clear();
+    StoreSink sink{ results };
+    // The extra values share one budget's worth of addresses between them
+    size_t extraLimit = extras ? results.budget() / sizeof(uintptr_t) / std::max<size_t>(1, extras->values.size()) : 0;
+    bool ok = searchMemoryForIntInto(pid, value, verbose, fingerprints, onProvisional, sink, extras, extraLimit, retarget);
+    if (verbose && results.spilled()) {
+        LOG_INFO("Candidate set exceeded the " + std::to_string(results.budget() >> 20) + " MiB budget and was spilled to disk.");
+    }
+    return ok;
+}
+
+bool refineCandidateStore(DWORD pid, CandidateStore& candidates, int newValue, CandidateStore& refined, bool verbose) {
+    refined.clear();
+    size_t examined = 0;
+    // Sorted batches keep both the spill-file reads and the process reads sequential
+    candidates.forEachSorted([&](const uintptr_t* batch, size_t count) {
+        std::vector<uintptr_t> addresses(batch, batch + count);
+        std::vector<int32_t> values = sampleCandidateValues(pid, addresses, false);
+        for (size_t i = 0; i < count; ++i) {
+            if (values[i] == newValue) {
+                refined.push(addresses[i]);
+            }
+        }
+        examined += count;
+    });
+
+    if (verbose) {
+        LOG_INFO("[Refine] Kept " + std::to_string(refined.size()) + " of " + std::to_string(examined) +
+                 " stored addresses matching new value: " + std::to_string(newValue) +
+                 (refined.spilled() ? " (still spilled)" : ""));
+    }
+    return true;
+}
+
+template <typename T>
+static std::vector<uintptr_t> searchMemoryForRanges(DWORD pid, const std::vector<ValueRange<T>>& ranges, const char* typeName, bool verbose) {
+    std::vector<uintptr_t> results;
+    if (ranges.empty()) {
+        return results;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            std::stringstream ss;
+            ss << "Failed to open process " << pid << " for " << typeName << " scan. Error code: " << GetLastError();
+            LOG_ERROR(ss.str());
+        }
+        return results;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    std::vector<MemoryRegion> memory_regions = collectReadableRegions(process_handle);
+    scanReadableMemory(process_handle, memory_regions, [&](uintptr_t base, const char* data, size_t length) {
+        matchRangesInChunk(base, data, length, ranges, results);
+    });
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        std::stringstream ss;
+        ss << "Initial " << typeName << " scan complete. Found " << results.size() << " matches across "
+           << ranges.size() << " display interval(s)";
+        LOG_INFO(ss.str());
+    }
+    return results;
+}
+
+std::vector<uintptr_t> searchMemoryForFloat(DWORD pid, const std::vector<FloatRange>& ranges, bool verbose) {
+    return searchMemoryForRanges(pid, ranges, "float", verbose);
+}
+
+std::vector<uintptr_t> searchMemoryForDouble(DWORD pid, const std::vector<DoubleRange>& ranges, bool verbose) {
+    return searchMemoryForRanges(pid, ranges, "double", verbose);
+}
+
+std::vector<std::vector<uintptr_t>> searchMemoryForInts(DWORD pid, const std::vector<int>& values, bool verbose) {
+    std::vector<std::vector<uintptr_t>> results(values.size());
+
+    // Repeated values share one needle; slot[i] is the needle values[i] maps to
+    std::vector<int32_t> needles;
+    std::vector<size_t> slot(values.size(), SIZE_MAX);
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto it = std::find(needles.begin(), needles.end(), values[i]);
+        if (it != needles.end()) {
+            slot[i] = static_cast<size_t>(it - needles.begin());
+        } else if (needles.size() < kMaxNeedles) {
+            slot[i] = needles.size();
+            needles.push_back(values[i]);
+        } else if (verbose) {
+            LOG_WARNING("Multi-value scan is limited to " + std::to_string(kMaxNeedles) + " distinct values; skipping " + std::to_string(values[i]) + ".");
+        }
+    }
+    if (needles.empty()) {
+        return results;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            std::stringstream ss;
+            ss << "Failed to open process " << pid << " for multi-value scan. Error code: " << GetLastError();
+            LOG_ERROR(ss.str());
+        }
+        return results;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    std::vector<std::vector<uintptr_t>> hits(needles.size());
+    std::vector<MemoryRegion> memory_regions = collectReadableRegions(process_handle);
+    scanReadableMemory(process_handle, memory_regions, [&](uintptr_t base, const char* data, size_t length) {
+        matchNeedlesInChunk(base, data, length, needles.data(), needles.size(), [&](uintptr_t address, size_t needle) {
+            hits[needle].push_back(address);
+        });
+    });
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (slot[i] != SIZE_MAX) {
+            results[i] = hits[slot[i]];
+        }
+    }
+
+    if (verbose) {
+        std::stringstream ss;
+        ss << "Multi-value scan complete.";
+        for (size_t i = 0; i < values.size(); ++i) {
+            ss << " " << values[i] << ": " << results[i].size() << (i + 1 < values.size() ? "," : ".");
+        }
         LOG_INFO(ss.str());
     }
     return results;
@@ -159,4 +635,324 @@ std::vector<uintptr_t> refineCandidates(DWORD pid, const std::vector<uintptr_t>&
     }
 
     return refinedList;
-}
\ No newline at end of file
+}
+
+template <typename T>
+static std::vector<uintptr_t> refineCandidatesForRanges(DWORD pid, const std::vector<uintptr_t>& candidates, const std::vector<ValueRange<T>>& ranges, bool verbose) {
+    std::vector<uintptr_t> refinedList;
+    if (candidates.empty() || ranges.empty()) {
+        return refinedList;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            LOG_ERROR("[Refine] Failed to open process " + std::to_string(pid) + ". Error: " + std::to_string(GetLastError()));
+        }
+        return refinedList;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    for (uintptr_t addr : candidates) {
+        T currentValue;
+        SIZE_T bytesRead = 0;
+        if (ReadProcessMemory(process_handle, (LPCVOID)addr, &currentValue, sizeof(currentValue), &bytesRead) &&
+            bytesRead == sizeof(currentValue) && valueInRanges(currentValue, ranges)) {
+            refinedList.push_back(addr);
+        }
+    }
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        LOG_INFO("[Refine] Kept " + std::to_string(refinedList.size()) + " of " + std::to_string(candidates.size()) + " display-matched addresses.");
+    }
+    return refinedList;
+}
+
+std::vector<uintptr_t> refineCandidatesFloat(DWORD pid, const std::vector<uintptr_t>& candidates, const std::vector<FloatRange>& ranges, bool verbose) {
+    return refineCandidatesForRanges(pid, candidates, ranges, verbose);
+}
+
+std::vector<uintptr_t> refineCandidatesDouble(DWORD pid, const std::vector<uintptr_t>& candidates, const std::vector<DoubleRange>& ranges, bool verbose) {
+    return refineCandidatesForRanges(pid, candidates, ranges, verbose);
+}
+
+std::vector<EncodedHit> searchMemoryForEncoded(DWORD pid, int value, const std::vector<ValueEncoding>& encodings, bool verbose,
+                                               SnapshotStore* baseline) {
+    std::vector<EncodedHit> results;
+
+    // Encodings that collapse onto the same stored value (e.g. anything of 0) are
+    // tested once, and a hit keeps every one of them until a refine tells them apart
+    std::vector<EncodingNeedle> groups = groupEncodings(encodings, value);
+    if (groups.size() > kMaxNeedles) {
+        if (verbose) {
+            LOG_WARNING("Encoded scan is limited to " + std::to_string(kMaxNeedles) + " distinct stored values; skipping " +
+                        std::to_string(groups.size() - kMaxNeedles) + ".");
+        }
+        groups.resize(kMaxNeedles);
+    }
+    std::vector<int32_t> needles;
+    for (const auto& group : groups) {
+        needles.push_back(group.stored);
+        if (verbose && group.encodings.size() > 1) {
+            std::string names;
+            for (const auto& encoding : group.encodings) {
+                names += (names.empty() ? "" : ", ") + describeEncoding(encoding);
+            }
+            LOG_INFO("Value " + std::to_string(value) + " is stored the same way by " + names + "; their hits stay ambiguous until the value changes.");
+        }
+    }
+    if (needles.empty()) {
+        return results;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            std::stringstream ss;
+            ss << "Failed to open process " << pid << " for encoded scan. Error code: " << GetLastError();
+            LOG_ERROR(ss.str());
+        }
+        return results;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    std::vector<MemoryRegion> memory_regions = collectReadableRegions(process_handle);
+    if (baseline) {
+        baseline->beginGeneration();
+    }
+    scanReadableMemory(process_handle, memory_regions, [&](uintptr_t base, const char* data, size_t length) {
+        matchNeedlesInChunk(base, data, length, needles.data(), needles.size(), [&](uintptr_t address, size_t needle) {
+            for (const auto& encoding : groups[needle].encodings) {
+                results.push_back({ address, encoding });
+            }
+        });
+        if (baseline) {
+            baseline->addChunk(base, data, length);
+        }
+    });
+    if (baseline) {
+        baseline->endGeneration();
+    }
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        std::stringstream ss;
+        ss << "Encoded scan complete. Found " << results.size() << " matches for value " << value
+           << " across " << needles.size() << " stored form(s)";
+        LOG_INFO(ss.str());
+    }
+    return results;
+}
+
+std::vector<EncodedHit> refineEncodedCandidates(DWORD pid, const std::vector<EncodedHit>& candidates, int newValue, bool verbose) {
+    std::vector<EncodedHit> refinedList;
+    if (candidates.empty()) {
+        return refinedList;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            LOG_ERROR("[Refine] Failed to open process " + std::to_string(pid) + ". Error: " + std::to_string(GetLastError()));
+        }
+        return refinedList;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    for (const auto& hit : candidates) {
+        int32_t currentValue = 0;
+        SIZE_T bytesRead = 0;
+        if (ReadProcessMemory(process_handle, (LPCVOID)hit.address, &currentValue, sizeof(currentValue), &bytesRead) &&
+            bytesRead == sizeof(currentValue) && currentValue == encodeValue(hit.encoding, newValue)) {
+            refinedList.push_back(hit);
+        }
+    }
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        LOG_INFO("[Refine] Kept " + std::to_string(refinedList.size()) + " of " + std::to_string(candidates.size()) +
+                 " encoded addresses matching new value: " + std::to_string(newValue));
+    }
+    return refinedList;
+}
+
+std::vector<EncodedHit> deriveEncodedHits(DWORD pid, SnapshotStore& baseline, int oldValue, int newValue, bool verbose) {
+    std::vector<EncodedHit> derived;
+    if (baseline.generationCount() == 0 || oldValue == newValue || !captureSnapshot(pid, baseline, false)) {
+        return derived;
+    }
+
+    // stored = v + offset moves by exactly as much as v does; stored = v ^ key flips exactly the bits v does.
+    // Offset 0 and key 0 are the plain value, which the listed encodings already cover.
+    uint32_t delta = static_cast<uint32_t>(newValue) - static_cast<uint32_t>(oldValue);
+    uint32_t flipped = static_cast<uint32_t>(newValue) ^ static_cast<uint32_t>(oldValue);
+    forEachChangedValue(baseline, *baseline.previous(), *baseline.latest(), [&](uintptr_t address, int32_t before, int32_t after) {
+        uint32_t stored = static_cast<uint32_t>(after);
+        if (stored - static_cast<uint32_t>(before) == delta && stored != static_cast<uint32_t>(newValue)) {
+            derived.push_back({ address, { EncodingKind::Offset, static_cast<int32_t>(stored - static_cast<uint32_t>(newValue)) } });
+        } else if ((stored ^ static_cast<uint32_t>(before)) == flipped && stored != static_cast<uint32_t>(newValue)) {
+            derived.push_back({ address, { EncodingKind::Xor, static_cast<int32_t>(stored ^ static_cast<uint32_t>(newValue)) } });
+        }
+    });
+
+    if (verbose) {
+        LOG_INFO("Derived " + std::to_string(derived.size()) + " offset/XOR-encoded candidates from " + std::to_string(oldValue) +
+                 " -> " + std::to_string(newValue) + ".");
+    }
+    return derived;
+}
+
+PageFingerprints fingerprintProcessMemory(DWORD pid, bool verbose) {
+    PageFingerprints fingerprints;
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            LOG_ERROR("Failed to open process " + std::to_string(pid) + " for fingerprinting. Error code: " + std::to_string(GetLastError()));
+        }
+        return fingerprints;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    std::vector<MemoryRegion> memory_regions = collectReadableRegions(process_handle);
+    size_t bytes = scanReadableMemory(process_handle, memory_regions, [](uintptr_t, const char*, size_t) {}, &fingerprints);
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        LOG_INFO("Fingerprinted " + std::to_string(fingerprints.pageCount()) + " pages (" + std::to_string(bytes) +
+                 " bytes) into " + std::to_string(fingerprints.memoryUsage()) + " bytes.");
+    }
+    return fingerprints;
+}
+
+std::vector<uintptr_t> searchPagesForInt(DWORD pid, const std::vector<uintptr_t>& pages, int value, bool verbose) {
+    std::vector<uintptr_t> results;
+    if (pages.empty()) {
+        return results;
+    }
+
+    // Adjacent pages are read as one region so the pipeline still gets large chunks
+    std::vector<MemoryRegion> memory_regions;
+    for (uintptr_t page : pages) {
+        if (!memory_regions.empty() && memory_regions.back().end_address == page) {
+            memory_regions.back().end_address += kFingerprintPageSize;
+        } else {
+            memory_regions.push_back({ page, page + kFingerprintPageSize });
+        }
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            LOG_ERROR("Failed to open process " + std::to_string(pid) + " for page scan. Error code: " + std::to_string(GetLastError()));
+        }
+        return results;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    scanReadableMemory(process_handle, memory_regions, [&](uintptr_t base, const char* data, size_t length) {
+        matchIntInChunk(base, data, length, value, results);
+    });
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        LOG_INFO("Page scan complete. Found " + std::to_string(results.size()) + " matches for value " +
+                 std::to_string(value) + " in " + std::to_string(pages.size()) + " pages.");
+    }
+    return results;
+}
+
+std::vector<int32_t> sampleCandidateValues(DWORD pid, const std::vector<uintptr_t>& candidates, bool verbose) {
+    std::vector<int32_t> values(candidates.size(), kUnreadableSample);
+    if (candidates.empty()) {
+        return values;
+    }
+
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            LOG_ERROR("[Sample] Failed to open process " + std::to_string(pid) + ". Error: " + std::to_string(GetLastError()));
+        }
+        return values;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    // Candidates are sorted, so neighbours within a page of each other are
+    // fetched with one read instead of one read per address.
+    const size_t max_gap = 4096;
+    const size_t max_window = 65536;
+    std::vector<char> buffer(max_window + sizeof(int32_t));
+    size_t first = 0;
+    while (first < candidates.size()) {
+        size_t last = first;
+        while (last + 1 < candidates.size() &&
+               candidates[last + 1] >= candidates[last] &&
+               candidates[last + 1] - candidates[last] <= max_gap &&
+               candidates[last + 1] - candidates[first] < max_window) {
+            ++last;
+        }
+
+        uintptr_t window_start = candidates[first];
+        size_t window_size = candidates[last] - window_start + sizeof(int32_t);
+        SIZE_T bytes_read = 0;
+        if (ReadProcessMemory(process_handle, (LPCVOID)window_start, buffer.data(), window_size, &bytes_read) && bytes_read == window_size) {
+            for (size_t i = first; i <= last; ++i) {
+                std::memcpy(&values[i], buffer.data() + (candidates[i] - window_start), sizeof(int32_t));
+            }
+        } else {
+            // The window crosses something unreadable; fall back to single reads
+            for (size_t i = first; i <= last; ++i) {
+                int32_t value = 0;
+                SIZE_T single_read = 0;
+                if (ReadProcessMemory(process_handle, (LPCVOID)candidates[i], &value, sizeof(value), &single_read) && single_read == sizeof(value)) {
+                    values[i] = value;
+                }
+            }
+        }
+        first = last + 1;
+    }
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+    return values;
+}
+
+bool captureSnapshot(DWORD pid, SnapshotStore& store, bool verbose) {
+    HANDLE process_handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+    if (process_handle == NULL) {
+        if (verbose) {
+            LOG_ERROR("Failed to open process " + std::to_string(pid) + " for snapshot. Error code: " + std::to_string(GetLastError()));
+        }
+        return false;
+    }
+    REGISTER_HANDLE(process_handle);
+
+    std::vector<MemoryRegion> memory_regions = collectReadableRegions(process_handle);
+    store.beginGeneration();
+    scanReadableMemory(process_handle, memory_regions, [&](uintptr_t base, const char* data, size_t length) {
+        store.addChunk(base, data, length);
+    });
+    store.endGeneration();
+
+    CloseHandle(process_handle);
+    UNREGISTER_HANDLE(process_handle);
+
+    if (verbose) {
+        SnapshotStats stats = store.stats();
+        LOG_INFO("Snapshot " + std::to_string(store.generationCount()) + " stored: " + std::to_string(stats.rawBytes >> 20) +
+                 " MiB raw across generations held in " + std::to_string(stats.storedBytes >> 20) + " MiB (" +
+                 std::to_string(stats.zeroPages) + " zero pages, " + std::to_string(stats.sharedPages) + " shared pages).");
+    }
+    return true;
+}
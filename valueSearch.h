@@ -2,7 +2,69 @@
 #include <vector>
 #include <stdint.h>
 #include <windows.h> 
+#include <functional>
+#include "displayMatch.h"
+#include "valueEncoding.h"
+#include "pageFingerprint.h"
+#include "candidateStore.h"
+#include "snapshotStore.h"
 
-std::vector<uintptr_t> searchMemoryForInt(DWORD pid, int value, bool verbose = true); 
+// Called mid-scan with the (sorted) matches from historically hot regions, and
+// again each time a retarget refines them to a new value
+using ProvisionalResultsFn = std::function<void(const std::vector<uintptr_t>&)>;
 
-std::vector<uintptr_t> refineCandidates(DWORD pid, const std::vector<uintptr_t>& candidates, int newValue, bool verbose = true); 
\ No newline at end of file
+// Polled between chunks of a scan; returns true and sets value when the value
+// on screen has moved on. The matches found so far are then refined to it and
+// the rest of memory is searched for it, as if a refine had followed the scan.
+using RetargetFn = std::function<bool(int& value)>;
+
+std::vector<uintptr_t> searchMemoryForInt(DWORD pid, int value, bool verbose = true, PageFingerprints* fingerprints = nullptr,
+                                          const ProvisionalResultsFn& onProvisional = nullptr); 
+
+// Values matched alongside the main one in the same pass, e.g. the 250 of "100/250".
+// hits[i] is sorted; it is left empty if values[i] matched more often than its
+// share of the candidate budget, so it can be searched again once it changes.
+struct ExtraValueScan {
+    std::vector<int> values;
+    std::vector<std::vector<uintptr_t>> hits;
+};
+
+// Same scan, with hits kept under the store's memory budget (spilling to disk past it).
+// value ends as the one searched for last; retargets stop once the store spills.
+bool searchMemoryForInt(DWORD pid, int& value, CandidateStore& results, bool verbose = true, PageFingerprints* fingerprints = nullptr,
+                        const ProvisionalResultsFn& onProvisional = nullptr, ExtraValueScan* extras = nullptr,
+                        const RetargetFn& retarget = nullptr);
+bool refineCandidateStore(DWORD pid, CandidateStore& candidates, int newValue, CandidateStore& refined, bool verbose = true);
+
+std::vector<uintptr_t> refineCandidates(DWORD pid, const std::vector<uintptr_t>& candidates, int newValue, bool verbose = true);
+
+// Several int32 values in one pass (up to 16 distinct); results[i] holds the sorted hits for values[i]
+std::vector<std::vector<uintptr_t>> searchMemoryForInts(DWORD pid, const std::vector<int>& values, bool verbose = true);
+
+// Display-aware scans: match any stored float/double that would be drawn as the OCR'd text
+std::vector<uintptr_t> searchMemoryForFloat(DWORD pid, const std::vector<FloatRange>& ranges, bool verbose = true);
+std::vector<uintptr_t> searchMemoryForDouble(DWORD pid, const std::vector<DoubleRange>& ranges, bool verbose = true);
+
+std::vector<uintptr_t> refineCandidatesFloat(DWORD pid, const std::vector<uintptr_t>& candidates, const std::vector<FloatRange>& ranges, bool verbose = true);
+std::vector<uintptr_t> refineCandidatesDouble(DWORD pid, const std::vector<uintptr_t>& candidates, const std::vector<DoubleRange>& ranges, bool verbose = true);
+
+// One pass over memory testing every encoding at once; each hit remembers which encoding matched.
+// With a baseline, the same pass also stores a snapshot generation for deriveEncodedHits.
+std::vector<EncodedHit> searchMemoryForEncoded(DWORD pid, int value, const std::vector<ValueEncoding>& encodings, bool verbose = true,
+                                               SnapshotStore* baseline = nullptr);
+std::vector<EncodedHit> refineEncodedCandidates(DWORD pid, const std::vector<EncodedHit>& candidates, int newValue, bool verbose = true);
+
+// Offsets and XOR keys nobody listed: snapshots memory again and keeps every int32 whose change
+// since the baseline matches oldValue -> newValue under a constant offset or key.
+std::vector<EncodedHit> deriveEncodedHits(DWORD pid, SnapshotStore& baseline, int oldValue, int newValue, bool verbose = true);
+
+// Page fingerprints: hash every readable page, then only re-read pages that changed
+PageFingerprints fingerprintProcessMemory(DWORD pid, bool verbose = true);
+std::vector<uintptr_t> searchPagesForInt(DWORD pid, const std::vector<uintptr_t>& pages, int value, bool verbose = true);
+
+// Current int32 at every candidate, read in batched windows; kUnreadableSample where the read failed
+static const int32_t kUnreadableSample = INT32_MIN;
+std::vector<int32_t> sampleCandidateValues(DWORD pid, const std::vector<uintptr_t>& candidates, bool verbose = true);
+
+// Adds one deduplicated full-memory generation to store
+bool captureSnapshot(DWORD pid, SnapshotStore& store, bool verbose = true);
@@ -0,0 +1,280 @@
+#include "writeWatch.h"
+//=====================//
+#if defined(__linux__) && defined(__x86_64__)
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <dirent.h>
+#include <pthread.h>
+#include <set>
+#include <signal.h>
+#include <time.h>
+#include <sys/ptrace.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+
+static long debugRegisterOffset(int index) {
+    return static_cast<long>(offsetof(struct user, u_debugreg) + index * sizeof(long));
+}
+
+static std::vector<pid_t> listThreads(pid_t pid) {
+    std::vector<pid_t> threads;
+    std::string path = "/proc/" + std::to_string(pid) + "/task";
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return threads;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            threads.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+        }
+    }
+    closedir(dir);
+    return threads;
+}
+
+// DR7 length field: the widest of 4/2/1 bytes the address is aligned for
+static unsigned long watchLengthBits(uintptr_t address) {
+    if (address % 4 == 0) {
+        return 0x3;
+    }
+    return address % 2 == 0 ? 0x1 : 0x0;
+}
+
+WriteWatcher::~WriteWatcher() {
+    stop();
+}
+
+void WriteWatcher::setError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    error = message + " (" + std::strerror(errno) + ")";
+}
+
+std::string WriteWatcher::lastError() const {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    return error;
+}
+
+bool WriteWatcher::start(pid_t targetPid, const std::vector<uintptr_t>& watchAddresses) {
+    if (running.load() || watchAddresses.empty()) {
+        return false;
+    }
+    pid = targetPid;
+    addresses.assign(watchAddresses.begin(), watchAddresses.begin() + std::min(watchAddresses.size(), kMaxWatchpoints));
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        events.clear();
+        hitCounts.assign(addresses.size(), 0);
+        error.clear();
+    }
+    stopRequested.store(false);
+
+    std::promise<bool> started;
+    std::future<bool> armed = started.get_future();
+    worker = std::thread(&WriteWatcher::watchLoop, this, &started);
+    if (!armed.get()) {
+        worker.join();
+        return false;
+    }
+    return true;
+}
+
+void WriteWatcher::stop() {
+    stopRequested.store(true);
+    if (worker.joinable()) {
+        pthread_kill(worker.native_handle(), SIGCHLD); // ends the worker's sigtimedwait
+        worker.join();
+    }
+}
+
+bool WriteWatcher::armThread(pid_t tid) {
+    unsigned long dr7 = 0;
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        if (ptrace(PTRACE_POKEUSER, tid, debugRegisterOffset(static_cast<int>(i)), addresses[i]) == -1) {
+            return false;
+        }
+        dr7 |= 1ul << (i * 2);                                    // local enable
+        dr7 |= 0x1ul << (16 + i * 4);                             // break on write
+        dr7 |= watchLengthBits(addresses[i]) << (18 + i * 4);
+    }
+    return ptrace(PTRACE_POKEUSER, tid, debugRegisterOffset(7), dr7) != -1;
+}
+
+void WriteWatcher::disarmThread(pid_t tid) {
+    ptrace(PTRACE_POKEUSER, tid, debugRegisterOffset(7), 0);
+}
+
+void WriteWatcher::recordTrap(pid_t tid) {
+    errno = 0;
+    unsigned long dr6 = static_cast<unsigned long>(ptrace(PTRACE_PEEKUSER, tid, debugRegisterOffset(6), 0));
+    if (errno != 0) {
+        return;
+    }
+    user_regs_struct regs{};
+    ptrace(PTRACE_GETREGS, tid, 0, &regs);
+
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        if (!(dr6 & (1ul << i))) {
+            continue;
+        }
+        errno = 0;
+        long word = ptrace(PTRACE_PEEKDATA, tid, addresses[i], 0);
+        int32_t value = errno == 0 ? static_cast<int32_t>(word) : 0;
+
+        std::lock_guard<std::mutex> lock(eventMutex);
+        if (events.size() == kWriteEventCapacity) {
+            events.pop_front();
+        }
+        events.push_back({ std::chrono::steady_clock::now(), i, addresses[i], static_cast<uintptr_t>(regs.rip), tid, value });
+        ++hitCounts[i];
+    }
+    // DR6 is sticky; clear it so the next trap reports only its own slot
+    ptrace(PTRACE_POKEUSER, tid, debugRegisterOffset(6), 0);
+}
+
+void WriteWatcher::watchLoop(std::promise<bool>* started) {
+    std::set<pid_t> traced;
+    std::set<pid_t> armed;
+
+    // Tracee stops raise SIGCHLD at this thread; keep it pending so sigtimedwait can sleep on it
+    sigset_t wakeSignals;
+    sigemptyset(&wakeSignals);
+    sigaddset(&wakeSignals, SIGCHLD);
+    pthread_sigmask(SIG_BLOCK, &wakeSignals, nullptr);
+
+    // Threads can appear while we attach, so keep listing until nothing is new
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (pid_t tid : listThreads(pid)) {
+            if (traced.count(tid)) {
+                continue;
+            }
+            if (ptrace(PTRACE_SEIZE, tid, 0, PTRACE_O_TRACECLONE) == -1) {
+                if (errno == ESRCH) {
+                    continue; // exited meanwhile
+                }
+                setError("ptrace(PTRACE_SEIZE) failed for thread " + std::to_string(tid));
+                break;
+            }
+            traced.insert(tid);
+            grew = true;
+            int status = 0;
+            ptrace(PTRACE_INTERRUPT, tid, 0, 0);
+            if (waitpid(tid, &status, __WALL) == tid && WIFSTOPPED(status)) {
+                if (armThread(tid)) {
+                    armed.insert(tid);
+                } else {
+                    setError("Failed to set debug registers on thread " + std::to_string(tid));
+                }
+                ptrace(PTRACE_CONT, tid, 0, 0);
+            }
+        }
+    }
+
+    if (armed.empty()) {
+        for (pid_t tid : traced) {
+            ptrace(PTRACE_DETACH, tid, 0, 0);
+        }
+        started->set_value(false);
+        return;
+    }
+    running.store(true);
+    started->set_value(true);
+
+    while (!stopRequested.load() && !traced.empty()) {
+        // __WNOTHREAD limits the wait to this thread's tracees; children of the
+        // rest of the process are never reaped here
+        int status = 0;
+        pid_t tid = waitpid(-1, &status, __WALL | __WNOTHREAD | WNOHANG);
+        if (tid == 0) {
+            // Nothing to handle: sleep until a tracee stops or stop() signals us. A stop that
+            // lands after the waitpid above leaves SIGCHLD pending, so it is not missed. The
+            // timeout only matters if another thread that leaves SIGCHLD unblocked takes it.
+            timespec timeout{ 0, 100 * 1000 * 1000 };
+            sigtimedwait(&wakeSignals, nullptr, &timeout);
+            continue;
+        }
+        if (tid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (WIFEXITED(status) || WIFSIGNALED(status)) {
+            traced.erase(tid);
+            armed.erase(tid);
+            continue;
+        }
+        if (!WIFSTOPPED(status)) {
+            continue;
+        }
+
+        int sig = WSTOPSIG(status);
+        unsigned event = static_cast<unsigned>(status) >> 16;
+        traced.insert(tid); // threads from TRACECLONE may report before their parent's clone event
+
+        if (event == PTRACE_EVENT_CLONE) {
+            unsigned long child = 0;
+            ptrace(PTRACE_GETEVENTMSG, tid, 0, &child);
+            traced.insert(static_cast<pid_t>(child));
+            ptrace(PTRACE_CONT, tid, 0, 0);
+        } else if (event == PTRACE_EVENT_STOP) {
+            // A new thread's first stop, or a group-stop (SIGSTOP and friends) we must not resume
+            if (!armed.count(tid)) {
+                if (armThread(tid)) {
+                    armed.insert(tid);
+                }
+                ptrace(PTRACE_CONT, tid, 0, 0);
+            } else if (sig == SIGTRAP) {
+                ptrace(PTRACE_CONT, tid, 0, 0);
+            } else {
+                ptrace(PTRACE_LISTEN, tid, 0, 0);
+            }
+        } else if (sig == SIGTRAP) {
+            errno = 0;
+            long dr6 = ptrace(PTRACE_PEEKUSER, tid, debugRegisterOffset(6), 0);
+            if (errno == 0 && (dr6 & 0xF)) {
+                recordTrap(tid);
+                ptrace(PTRACE_CONT, tid, 0, 0);
+            } else {
+                ptrace(PTRACE_CONT, tid, 0, SIGTRAP); // not ours (e.g. a breakpoint of the target's own)
+            }
+        } else {
+            ptrace(PTRACE_CONT, tid, 0, sig);
+        }
+    }
+
+    // Each thread has to be stopped to clear its registers and detach
+    for (pid_t tid : traced) {
+        if (ptrace(PTRACE_INTERRUPT, tid, 0, 0) == -1) {
+            continue;
+        }
+        int status = 0;
+        if (waitpid(tid, &status, __WALL) != tid || !WIFSTOPPED(status)) {
+            continue;
+        }
+        int sig = WSTOPSIG(status);
+        unsigned event = static_cast<unsigned>(status) >> 16;
+        bool signalStop = event == 0 && sig != SIGTRAP;
+        disarmThread(tid);
+        ptrace(PTRACE_DETACH, tid, 0, signalStop ? sig : 0);
+    }
+    running.store(false);
+}
+
+std::vector<WriteEvent> WriteWatcher::takeEvents() {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    std::vector<WriteEvent> taken(events.begin(), events.end());
+    events.clear();
+    return taken;
+}
+
+std::vector<size_t> WriteWatcher::getHitCounts() const {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    return hitCounts;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef WRITEWATCH_H
+#define WRITEWATCH_H
+
+// Hardware write watchpoints on candidate addresses (Linux/x86-64 only).
+// Instead of polling candidates, the target's own threads trap on every write
+// to up to four addresses, telling us which candidate tracks the screen and
+// which instruction writes it.
+#if defined(__linux__) && defined(__x86_64__)
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+
+static const size_t kMaxWatchpoints = 4;       // DR0-DR3
+static const size_t kWriteEventCapacity = 4096; // oldest events are dropped past this
+
+struct WriteEvent {
+    std::chrono::steady_clock::time_point time;
+    size_t slot;              // index into the watched address list
+    uintptr_t address;
+    uintptr_t instruction;    // RIP after the trap: the instruction following the write
+    pid_t thread;
+    int32_t value;            // value at the address right after the write
+};
+
+class WriteWatcher {
+    pid_t pid = 0;
+    std::vector<uintptr_t> addresses;
+    std::thread worker;
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> running{ false };
+
+    mutable std::mutex eventMutex;
+    std::deque<WriteEvent> events;
+    std::vector<size_t> hitCounts;
+    std::string error;
+
+    // ptrace requests must all come from the attaching thread
+    void watchLoop(std::promise<bool>* started);
+    bool armThread(pid_t tid);
+    void disarmThread(pid_t tid);
+    void recordTrap(pid_t tid);
+    void setError(const std::string& message);
+
+public:
+    WriteWatcher() = default;
+    ~WriteWatcher();
+
+    WriteWatcher(const WriteWatcher&) = delete;
+    WriteWatcher& operator=(const WriteWatcher&) = delete;
+
+    // Attaches to every thread of targetPid and arms one write watchpoint per
+    // address (only the first kMaxWatchpoints are used). Blocks until armed.
+    // The worker sleeps on SIGCHLD; block it in every thread of the caller so
+    // none of them swallows a wakeup.
+    bool start(pid_t targetPid, const std::vector<uintptr_t>& watchAddresses);
+    void stop();
+    bool isRunning() const { return running.load(); }
+
+    std::vector<WriteEvent> takeEvents();
+    std::vector<size_t> getHitCounts() const;
+    const std::vector<uintptr_t>& getAddresses() const { return addresses; }
+    std::string lastError() const;
+};
+
+#endif
+
+#endif